@@ -0,0 +1,24 @@
+#!/bin/sh
+# Build the game in double and single precision, then check the single precision trajectories against the double precision ones
+#   ./check_precision.sh [tolerance in pixels, 1 by default]
+# SDL_FLAGS replaces the SDL include and link options of the compile line (-Iinclude -Llib -lSDL2_gfx -lSDL2 by default)
+
+cd "$(dirname "$0")" || exit 1
+
+TOLERANCE=${1:-1}
+SDL_FLAGS=${SDL_FLAGS:--Iinclude -Llib -lSDL2_gfx -lSDL2}
+
+SOURCES="source_code/main.c source_code/vue_controller/vue_controller.c source_code/vue_controller/rasterizer.c source_code/vue_controller/hud.c source_code/vue_controller/particles.c source_code/vue_controller/heatmap.c source_code/vue_controller/trail.c source_code/model/model.c source_code/batch/batch.c source_code/server/server.c source_code/hot_reload/hot_reload.c source_code/snapshot/snapshot.c source_code/profiler/profiler.c source_code/playlist/playlist.c source_code/nbody/nbody.c source_code/timeline/timeline.c source_code/telemetry/telemetry.c source_code/worker_pool/worker_pool.c"
+
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+echo "Building the double precision game"
+gcc $SOURCES -o "$WORK/double.exe" $SDL_FLAGS -lm -Wall || exit 1
+
+echo "Building the single precision game"
+gcc -DSINGLE_PRECISION_PHYSICS $SOURCES -o "$WORK/single.exe" $SDL_FLAGS -lm -Wall || exit 1
+
+# Same scenarios, seed and policy for both builds
+"$WORK/double.exe" --batch . --policy greedy --seed 1 --save-trace "$WORK/double.txt" > /dev/null || exit 1
+"$WORK/single.exe" --batch . --policy greedy --seed 1 --check-trace "$WORK/double.txt" --tolerance "$TOLERANCE"
@@ -0,0 +1,495 @@
+#include <stdbool.h>
+#include <dirent.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "batch.h"
+#include "../model/model.h"
+
+#define DEFAULT_MAX_TICKS 10000
+#define MAX_PATH_LENGTH   512
+
+// Number of ticks between two recorded positions of a trajectory
+#define TRACE_INTERVAL 10
+#define DEFAULT_TRACE_TOLERANCE 1.0
+
+typedef enum {
+    NO_INPUT,
+    RANDOM_INPUT,
+    GREEDY_INPUT
+} InputPolicy;
+
+typedef enum {
+    RESULT_WIN,
+    RESULT_LOSS,
+    RESULT_TIMEOUT,
+    RESULT_ERROR
+} ScenarioResult;
+
+typedef struct {
+    char path[MAX_PATH_LENGTH];
+
+    ScenarioResult result;
+    int nbTicks;
+    int score;
+
+    // Wall time of the run (in milliseconds)
+    double wallTime;
+
+    // Positions of the spaceship every TRACE_INTERVAL ticks, in a toric world of the given size
+    int worldWidth, worldHeight;
+    int nbSamples;
+    Position * samples;
+} Scenario;
+
+typedef struct {
+    int nbScenarios;
+    int capacity;
+    Scenario * scenarios;
+
+    SDL_atomic_t nextScenario;
+
+    unsigned int seed;
+    InputPolicy policy;
+    int maxTicks;
+    double gravityCutoff;
+
+    // Trajectories recording (when saved or checked)
+    bool traced;
+} Batch;
+
+static char * resultNames[] = {"WIN", "LOSS", "TIMEOUT", "ERROR"};
+
+/**
+ * Add a configuration file to the batch
+ * 
+ * @param batch The batch
+ * @param path Path of the configuration file
+*/
+void addScenario(Batch * batch, char * path) {
+    if (batch->nbScenarios == batch->capacity) {
+        batch->capacity = batch->capacity == 0 ? 16 : 2 * batch->capacity;
+        batch->scenarios = realloc(batch->scenarios, batch->capacity * sizeof(Scenario));
+    }
+
+    Scenario scenario = {0};
+    snprintf(scenario.path, MAX_PATH_LENGTH, "%s", path);
+
+    batch->scenarios[batch->nbScenarios++] = scenario;
+}
+
+/**
+ * Add all the configuration files (config*.txt) of a directory to the batch
+ * 
+ * @param batch The batch
+ * @param path Path of the directory
+ * 
+ * @return True if the directory could be read, false otherwise
+*/
+bool addDirectoryScenarios(Batch * batch, char * path) {
+    DIR * directory = opendir(path);
+
+    if (directory == NULL) return false;
+
+    struct dirent * entry;
+
+    while ((entry = readdir(directory)) != NULL) {
+        char * name = entry->d_name;
+        int length = strlen(name);
+
+        if (strncmp(name, "config", 6) != 0 || length < 4 || strcmp(name + length - 4, ".txt") != 0) continue;
+
+        char filePath[MAX_PATH_LENGTH];
+        snprintf(filePath, MAX_PATH_LENGTH, "%s/%s", path, name);
+
+        addScenario(batch, filePath);
+    }
+
+    closedir(directory);
+    return true;
+}
+
+/**
+ * Compare two scenarios by path (for qsort)
+*/
+int compareScenarios(const void * a, const void * b) {
+    return strcmp(((Scenario *) a)->path, ((Scenario *) b)->path);
+}
+
+/**
+ * Press the direction keys of a game according to an input policy
+ * 
+ * @param game The game
+ * @param policy The input policy
+ * @param policyState State of the random numbers generator of the policy
+*/
+void applyInputPolicy(Game * game, InputPolicy policy, unsigned int * policyState) {
+    switch (policy) {
+        case NO_INPUT : {
+            break;
+        }
+
+        case RANDOM_INPUT : {
+            // A direction is held for several ticks, like a player would
+            if (getRandomNumber(policyState) < 0.05) {
+                double choice = getRandomNumber(policyState);
+
+                stopTurningLeft(game);
+                stopTurningRight(game);
+
+                if (choice < 1.0 / 3) {
+                    startTurningLeft(game);
+                } else if (choice < 2.0 / 3) {
+                    startTurningRight(game);
+                }
+            }
+
+            break;
+        }
+
+        case GREEDY_INPUT : {
+            Spaceship spaceship = game->configuration.spaceship;
+
+            // Signed angle between the trajectory and the direction of the arrival point
+            Vector target = toroidalDelta(game, spaceship.position, game->configuration.arrivalPoint);
+
+            double angle = atan2(
+                spaceship.velocity.vecX * target.vecY - spaceship.velocity.vecY * target.vecX,
+                spaceship.velocity.vecX * target.vecX + spaceship.velocity.vecY * target.vecY
+            );
+
+            stopTurningLeft(game);
+            stopTurningRight(game);
+
+            if (angle >  M_PI / 60) startTurningRight(game);
+            if (angle < -M_PI / 60) startTurningLeft(game);
+
+            break;
+        }
+    }
+}
+
+/**
+ * Play a scenario headless until it is won, lost or out of time
+ * 
+ * @param batch The batch giving the seed, the input policy and the ticks limit
+ * @param scenario The scenario
+*/
+void runScenario(Batch * batch, Scenario * scenario) {
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    // Model instance owned by this run only
+    Game game;
+
+    if (!loadConfigFile(&game, scenario->path)) {
+        scenario->result = RESULT_ERROR;
+        scenario->wallTime = (SDL_GetPerformanceCounter() - startCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+        return;
+    }
+
+    setSeed(&game, batch->seed);
+    setGravityCutoff(&game, batch->gravityCutoff);
+
+    unsigned int policyState = mixSeed(batch->seed + 1);
+
+    startTime(&game);
+    startGame(&game);
+
+    scenario->result = RESULT_TIMEOUT;
+    scenario->worldWidth = game.configuration.worldWidth;
+    scenario->worldHeight = game.configuration.worldHeight;
+
+    int tick = 0;
+
+    while (tick < batch->maxTicks) {
+        applyInputPolicy(&game, batch->policy, &policyState);
+
+        advanceTime(&game, TICK_DURATION);
+        rotatePlanets(&game);
+        moveSpaceship(&game);
+
+        tick++;
+
+        if (batch->traced && tick % TRACE_INTERVAL == 0) {
+            scenario->samples = realloc(scenario->samples, (scenario->nbSamples + 1) * sizeof(Position));
+            scenario->samples[scenario->nbSamples++] = game.configuration.spaceship.position;
+        }
+
+        // Winning and losing conditions checking
+        if (isGameWin(&game)) {
+            scenario->result = RESULT_WIN;
+            break;
+        } else if (isGameLost(&game)) {
+            scenario->result = RESULT_LOSS;
+            break;
+        }
+    }
+
+    scenario->nbTicks = tick;
+    scenario->score = game.configuration.score;
+
+    freeAllocations(&game);
+
+    scenario->wallTime = (SDL_GetPerformanceCounter() - startCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+/**
+ * Main function of a batch worker: runs scenarios until there is none left
+ * 
+ * @param data The batch
+ * 
+ * @return Always 0
+*/
+int batchWorker(void * data) {
+    Batch * batch = data;
+    int index;
+
+    while ((index = SDL_AtomicAdd(&batch->nextScenario, 1)) < batch->nbScenarios) {
+        runScenario(batch, &batch->scenarios[index]);
+    }
+
+    return 0;
+}
+
+/**
+ * Print the results of all the scenarios
+ * 
+ * @param batch The batch
+ * @param totalTime Wall time of the whole batch (in milliseconds)
+*/
+void printBatchSummary(Batch * batch, double totalTime) {
+    int nbResults[4] = {0};
+
+    printf("%-40s %-8s %8s %8s %12s\n", "Configuration", "Result", "Ticks", "Score", "Time (ms)");
+
+    for (int i = 0; i < batch->nbScenarios; i++) {
+        Scenario scenario = batch->scenarios[i];
+
+        nbResults[scenario.result]++;
+
+        printf("%-40s %-8s %8d %8d %12.2f\n", scenario.path, resultNames[scenario.result], scenario.nbTicks, scenario.score, scenario.wallTime);
+    }
+
+    printf("\n%d scenarios : %d won, %d lost, %d timed out, %d errors in %.2f ms\n",
+        batch->nbScenarios, nbResults[RESULT_WIN], nbResults[RESULT_LOSS], nbResults[RESULT_TIMEOUT], nbResults[RESULT_ERROR], totalTime);
+}
+
+/**
+ * Write the outcomes and trajectories of all the scenarios in a trace file
+ * 
+ * @param batch The batch
+ * @param path Path of the trace file
+ * 
+ * @return True if the file was written, false otherwise
+*/
+bool saveTrace(Batch * batch, char * path) {
+    FILE * file = fopen(path, "w");
+
+    if (file == NULL) {
+        printf("Can't write the trace file (%s).\n", path);
+        return false;
+    }
+
+    for (int i = 0; i < batch->nbScenarios; i++) {
+        Scenario scenario = batch->scenarios[i];
+
+        fprintf(file, "%s %s %d %d\n", scenario.path, resultNames[scenario.result], scenario.nbTicks, scenario.nbSamples);
+
+        for (int j = 0; j < scenario.nbSamples; j++) {
+            fprintf(file, "%.17g %.17g\n", (double) scenario.samples[j].posX, (double) scenario.samples[j].posY);
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+/**
+ * Compare the outcomes and trajectories of all the scenarios with a trace file, for example one written by a build of another precision
+ * 
+ * @param batch The batch
+ * @param path Path of the trace file
+ * @param tolerance Largest distance allowed between two positions of the same tick (in pixels)
+ * 
+ * @return True if every scenario has the same outcome and stays within the tolerance, false otherwise
+*/
+bool checkTrace(Batch * batch, char * path, double tolerance) {
+    FILE * file = fopen(path, "r");
+
+    if (file == NULL) {
+        printf("Can't open the trace file (%s).\n", path);
+        return false;
+    }
+
+    int nbFailures = 0;
+
+    printf("\n%-40s %-8s %8s %14s\n", "Configuration", "Trace", "Ticks", "Deviation (px)");
+
+    for (int i = 0; i < batch->nbScenarios; i++) {
+        Scenario scenario = batch->scenarios[i];
+
+        char tracedPath[MAX_PATH_LENGTH];
+        char tracedResult[16];
+        int tracedTicks, nbTracedSamples;
+
+        if (fscanf(file, "%511s %15s %d %d", tracedPath, tracedResult, &tracedTicks, &nbTracedSamples) != 4 || strcmp(tracedPath, scenario.path) != 0) {
+            printf("%-40s %-8s\n", scenario.path, "MISSING");
+            nbFailures++;
+            break;
+        }
+
+        // Largest distance between the two trajectories over their common ticks
+        double deviation = 0;
+
+        for (int j = 0; j < nbTracedSamples; j++) {
+            double posX, posY;
+
+            if (fscanf(file, "%le %le", &posX, &posY) != 2) break;
+            if (j >= scenario.nbSamples) continue;
+
+            double dX = fabs(scenario.samples[j].posX - posX);
+            double dY = fabs(scenario.samples[j].posY - posY);
+
+            // Positions on both sides of an edge of the world are close
+            if (dX > scenario.worldWidth  / 2.0) dX = scenario.worldWidth  - dX;
+            if (dY > scenario.worldHeight / 2.0) dY = scenario.worldHeight - dY;
+
+            double distance = hypot(dX, dY);
+
+            if (distance > deviation) deviation = distance;
+        }
+
+        bool passed = !strcmp(tracedResult, resultNames[scenario.result]) && tracedTicks == scenario.nbTicks && deviation <= tolerance;
+
+        if (!passed) nbFailures++;
+
+        printf("%-40s %-8s %8d %14.6f\n", scenario.path, passed ? "OK" : "FAILED", tracedTicks - scenario.nbTicks, deviation);
+    }
+
+    fclose(file);
+
+    printf("\n%d scenarios out of the tolerance (%.3f px)\n", nbFailures, tolerance);
+
+    return nbFailures == 0;
+}
+
+/**
+ * Print the usage of the batch mode
+*/
+void printBatchUsage() {
+    printf("Usage : --batch <directory or configuration file>... [--seed N] [--policy none|random|greedy] [--workers N] [--max-ticks N] [--gravity-cutoff R] [--save-trace FILE] [--check-trace FILE] [--tolerance PX]\n");
+}
+
+/**
+ * Run headless all the configuration files given on the command line, in parallel
+ * 
+ * @param argc Number of arguments following --batch
+ * @param argv Arguments following --batch
+ * 
+ * @return Exit code of the program
+*/
+int runBatch(int argc, char * argv[]) {
+    Batch batch = {0};
+
+    batch.seed = 0;
+    batch.policy = NO_INPUT;
+    batch.maxTicks = DEFAULT_MAX_TICKS;
+
+    int nbWorkers = SDL_GetCPUCount();
+
+    char * savedTracePath = NULL;
+    char * checkedTracePath = NULL;
+    double tolerance = DEFAULT_TRACE_TOLERANCE;
+
+    // Arguments reading
+    for (int i = 0; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+
+        if (!strcmp(argv[i], "--seed") && hasValue) {
+            batch.seed = strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "--workers") && hasValue) {
+            nbWorkers = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--max-ticks") && hasValue) {
+            batch.maxTicks = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--gravity-cutoff") && hasValue) {
+            batch.gravityCutoff = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--save-trace") && hasValue) {
+            savedTracePath = argv[++i];
+        } else if (!strcmp(argv[i], "--check-trace") && hasValue) {
+            checkedTracePath = argv[++i];
+        } else if (!strcmp(argv[i], "--tolerance") && hasValue) {
+            tolerance = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--policy") && hasValue) {
+            i++;
+
+            if (!strcmp(argv[i], "none")) {
+                batch.policy = NO_INPUT;
+            } else if (!strcmp(argv[i], "random")) {
+                batch.policy = RANDOM_INPUT;
+            } else if (!strcmp(argv[i], "greedy")) {
+                batch.policy = GREEDY_INPUT;
+            } else {
+                printf("Unknown input policy (%s)\n", argv[i]);
+                printBatchUsage();
+                free(batch.scenarios);
+                return 1;
+            }
+        } else if (!strncmp(argv[i], "--", 2)) {
+            printf("Unknown or incomplete option (%s)\n", argv[i]);
+            printBatchUsage();
+            free(batch.scenarios);
+            return 1;
+        } else if (!addDirectoryScenarios(&batch, argv[i])) {
+            // Not a directory, so a configuration file
+            addScenario(&batch, argv[i]);
+        }
+    }
+
+    if (batch.nbScenarios == 0) {
+        printf("No configuration file to run\n");
+        printBatchUsage();
+        return 1;
+    }
+
+    qsort(batch.scenarios, batch.nbScenarios, sizeof(Scenario), compareScenarios);
+
+    batch.traced = savedTracePath != NULL || checkedTracePath != NULL;
+
+    if (nbWorkers < 1) nbWorkers = 1;
+    if (nbWorkers > batch.nbScenarios) nbWorkers = batch.nbScenarios;
+
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    SDL_AtomicSet(&batch.nextScenario, 0);
+
+    // The main thread is one of the workers
+    SDL_Thread ** workers = malloc(nbWorkers * sizeof(SDL_Thread *));
+
+    for (int i = 1; i < nbWorkers; i++) {
+        workers[i] = SDL_CreateThread(batchWorker, "batch", &batch);
+    }
+
+    batchWorker(&batch);
+
+    for (int i = 1; i < nbWorkers; i++) {
+        SDL_WaitThread(workers[i], NULL);
+    }
+
+    free(workers);
+
+    printBatchSummary(&batch, (SDL_GetPerformanceCounter() - startCounter) * 1000.0 / SDL_GetPerformanceFrequency());
+
+    int exitCode = 0;
+
+    // Trajectories saving and checking
+    if (savedTracePath != NULL && !saveTrace(&batch, savedTracePath)) exitCode = 1;
+    if (checkedTracePath != NULL && !checkTrace(&batch, checkedTracePath, tolerance)) exitCode = 1;
+
+    for (int i = 0; i < batch.nbScenarios; i++) {
+        free(batch.scenarios[i].samples);
+    }
+
+    free(batch.scenarios);
+
+    return exitCode;
+}
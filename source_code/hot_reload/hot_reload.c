@@ -0,0 +1,185 @@
+#include <stdbool.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "../model/model.h"
+#include "hot_reload.h"
+
+#define WATCH_POLL_DELAY 100
+
+static char watchedPath[512];
+static char * watchedFileName;
+
+static int inotifyDescriptor = -1;
+static SDL_Thread * watcherThread;
+static SDL_atomic_t stopWatching;
+
+// Configuration parsed by the watcher and waiting to be applied between two frames
+static SDL_mutex * pendingMutex;
+static Game * pendingGame;
+
+#ifdef __linux__
+
+/**
+ * Main function of the watcher: parses the configuration file each time it is written
+ * 
+ * @param data Unused
+ * 
+ * @return Always 0
+*/
+int watchConfigFile(void * data) {
+    char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+    while (!SDL_AtomicGet(&stopWatching)) {
+        struct pollfd pollDescriptor = {inotifyDescriptor, POLLIN, 0};
+
+        // Waking up regularly to check if the watcher must stop
+        if (poll(&pollDescriptor, 1, WATCH_POLL_DELAY) <= 0) continue;
+
+        ssize_t length = read(inotifyDescriptor, buffer, sizeof(buffer));
+
+        bool fileChanged = false;
+
+        // Iterate through all the events of the directory
+        for (char * pointer = buffer; pointer < buffer + length; ) {
+            struct inotify_event * event = (struct inotify_event *) pointer;
+
+            if (event->len > 0 && !strcmp(event->name, watchedFileName)) {
+                fileChanged = true;
+            }
+
+            pointer += sizeof(struct inotify_event) + event->len;
+        }
+
+        if (!fileChanged) continue;
+
+        // Full parsing and checking, far from the game loop
+        Game * game = malloc(sizeof(Game));
+
+        if (!loadConfigFile(game, watchedPath)) {
+            printf("Configuration not reloaded (%s).\n", watchedPath);
+            free(game);
+            continue;
+        }
+
+        SDL_LockMutex(pendingMutex);
+
+        // A newer version replaces the one not applied yet
+        if (pendingGame != NULL) {
+            freeAllocations(pendingGame);
+            free(pendingGame);
+        }
+
+        pendingGame = game;
+
+        SDL_UnlockMutex(pendingMutex);
+    }
+
+    return 0;
+}
+
+#endif
+
+/**
+ * Start watching a configuration file in the background
+ * 
+ * @param path Path of the configuration file
+ * 
+ * @return True if the file is watched, false otherwise
+*/
+bool startConfigWatcher(char * path) {
+#ifdef __linux__
+    snprintf(watchedPath, sizeof(watchedPath), "%s", path);
+
+    // Editors often replace the file, so its directory is watched rather than the file itself
+    char directory[512];
+    snprintf(directory, sizeof(directory), "%s", path);
+
+    char * lastSlash = strrchr(directory, '/');
+
+    if (lastSlash == NULL) {
+        strcpy(directory, ".");
+        watchedFileName = watchedPath;
+    } else {
+        *lastSlash = '\0';
+        watchedFileName = watchedPath + (lastSlash - directory) + 1;
+    }
+
+    inotifyDescriptor = inotify_init();
+
+    if (inotifyDescriptor < 0 || inotify_add_watch(inotifyDescriptor, directory, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        printf("Can't watch the configuration file (%s).\n", path);
+        if (inotifyDescriptor >= 0) close(inotifyDescriptor);
+        return false;
+    }
+
+    pendingMutex = SDL_CreateMutex();
+    pendingGame = NULL;
+    SDL_AtomicSet(&stopWatching, 0);
+
+    watcherThread = SDL_CreateThread(watchConfigFile, "config watcher", NULL);
+
+    return true;
+#else
+    printf("Configuration hot reload is only available on Linux\n");
+    return false;
+#endif
+}
+
+/**
+ * Apply the last reloaded configuration to the game, if any (never waits for the watcher)
+ * 
+ * @param game The running game
+ * 
+ * @return True if some objects of the game changed, false otherwise
+*/
+bool applyConfigChanges(Game * game) {
+    if (watcherThread == NULL) return false;
+
+    // The watcher is publishing a configuration: it will be applied on the next frame
+    if (SDL_TryLockMutex(pendingMutex) != 0) return false;
+
+    Game * newGame = pendingGame;
+    pendingGame = NULL;
+
+    SDL_UnlockMutex(pendingMutex);
+
+    if (newGame == NULL) return false;
+
+    int nbChanges = updateConfiguration(game, &newGame->configuration);
+
+    printf("Configuration reloaded : %d objects changed\n", nbChanges);
+
+    freeAllocations(newGame);
+    free(newGame);
+
+    return nbChanges > 0;
+}
+
+/**
+ * Stop watching the configuration file
+*/
+void stopConfigWatcher() {
+#ifdef __linux__
+    if (watcherThread == NULL) return;
+
+    SDL_AtomicSet(&stopWatching, 1);
+    SDL_WaitThread(watcherThread, NULL);
+    watcherThread = NULL;
+
+    close(inotifyDescriptor);
+
+    if (pendingGame != NULL) {
+        freeAllocations(pendingGame);
+        free(pendingGame);
+    }
+
+    SDL_DestroyMutex(pendingMutex);
+#endif
+}
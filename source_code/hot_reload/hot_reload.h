@@ -0,0 +1,8 @@
+#ifndef HOT_RELOAD_H
+#define HOT_RELOAD_H
+
+bool startConfigWatcher(char * path);
+bool applyConfigChanges(Game * game);
+void stopConfigWatcher();
+
+#endif
\ No newline at end of file
@@ -1,37 +1,262 @@
 #include <stdbool.h>
+#include <limits.h>
 
 #include <SDL2/SDL2_gfxPrimitives.h>
 
 #include "model/model.h"
 #include "vue_controller/vue_controller.h"
+#include "vue_controller/hud.h"
+#include "vue_controller/particles.h"
+#include "vue_controller/trail.h"
+#include "batch/batch.h"
+#include "server/server.h"
+#include "hot_reload/hot_reload.h"
+#include "snapshot/snapshot.h"
+#include "profiler/profiler.h"
+#include "playlist/playlist.h"
+#include "nbody/nbody.h"
+#include "timeline/timeline.h"
+#include "telemetry/telemetry.h"
 
 #define FPS 1000/60
+#define SNAPSHOT_PATH "snapshot.bin"
+#define EXPLOSION_DURATION 2000
+
+// Ticks skipped by a seek in the timeline (10 seconds)
+#define SEEK_TICKS 600
+
+// Milliseconds of a frame that the ticks can use at the most
+#define PHYSICS_BUDGET 12
+
+/**
+ * Replace the won level by the next one of the playlist, between two frames
+ * 
+ * @param game The running game
+ * @param gravityCutoff Distance of the gravity pulls
+ * 
+ * @return True if a level was left, false otherwise
+*/
+bool goToNextLevel(Game * game, double gravityCutoff) {
+    Configuration configuration = getConfiguration(game);
+    Game * level;
+
+    // The window keeps the size of the first level
+    while ((level = takeNextLevel()) != NULL) {
+        if (level->configuration.winWidth == configuration.winWidth && level->configuration.winHeight == configuration.winHeight) break;
+
+        printf("Level skipped (%s) : its window size differs from the first level\n", getCurrentLevelPath());
+
+        freeAllocations(level);
+        free(level);
+    }
+
+    if (level == NULL) return false;
+
+    // The trail of the spaceship is kept for the next level
+    Trail * trail = game->trail;
+    clearTrail(trail);
+
+    freeAllocations(game);
+    *game = *level;
+    game->trail = trail;
+    free(level);
+
+    setGravityCutoff(game, gravityCutoff);
+
+    return true;
+}
+
+/**
+ * Print the speed of the game
+ * 
+ * @param timeScale Number of ticks per frame (0 for as many as possible)
+*/
+void printTimeScale(double timeScale) {
+    if (timeScale > 0) {
+        printf("Time scale : x%g\n", timeScale);
+    } else {
+        printf("Time scale : as fast as possible\n");
+    }
+}
+
+/**
+ * Move the game to another tick of its timeline
+ * 
+ * @param game The game
+ * @param tick Tick to reach
+ * 
+ * @return True if the spaceship was launched at this tick, false otherwise
+*/
+bool goToTick(Game * game, int tick) {
+    bool started = seekTimeline(game, tick);
+
+    printf("Timeline : %.1f s / %.1f s\n", getTimelineTick() * TICK_DURATION / 1000.0, getTimelineLength() * TICK_DURATION / 1000.0);
+
+    return started;
+}
 
 /**
  * Main function of the main program
 */
 int main(int argc, char * argv[]) {
-    // Configuration file reading
-    loadConfigFile(argv[1]);
+    // Headless batch mode
+    if (argc > 1 && !strcmp(argv[1], "--batch")) {
+        return runBatch(argc - 2, argv + 2);
+    }
+
+    // Headless control through a local socket
+    if (argc > 1 && !strcmp(argv[1], "--serve")) {
+        return runServer(argc - 2, argv + 2);
+    }
+
+    // Headless timing of the N-body steps
+    if (argc > 1 && !strcmp(argv[1], "--n-body-benchmark")) {
+        return runNBodyBenchmark(argc - 2, argv + 2);
+    }
+
+    bool hotReload = false;
+    bool perfCounters = false;
+    bool dirtyRects = false;
+    bool nBody = false;
+    double gravityCutoff = 0;
+    char * telemetryName = NULL;
+
+    // Configuration files of the levels, before the options
+    int nbLevels = 0;
+
+    while (nbLevels + 1 < argc && strncmp(argv[nbLevels + 1], "--", 2)) {
+        nbLevels++;
+    }
+
+    if (nbLevels == 0) {
+        printf("No configuration file\n");
+        return 1;
+    }
+
+    // Command line options reading
+    for (int i = nbLevels + 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--dirty-rects")) {
+            dirtyRects = true;
+        } else if (!strcmp(argv[i], "--tiled-raster")) {
+            setTiledRasterMode(true);
+        } else if (!strcmp(argv[i], "--hot-reload")) {
+            hotReload = true;
+        } else if (!strcmp(argv[i], "--n-body")) {
+            nBody = true;
+        } else if (!strcmp(argv[i], "--perf-counters")) {
+            perfCounters = true;
+        } else if (!strcmp(argv[i], "--telemetry") && i + 1 < argc) {
+            telemetryName = argv[++i];
+        } else if (!strcmp(argv[i], "--gravity-cutoff") && i + 1 < argc) {
+            gravityCutoff = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--render-scale") && i + 1 < argc) {
+            float renderScale = atof(argv[++i]);
+
+            if (renderScale <= 0 || renderScale > 1) {
+                printf("The render scale must be greater than 0 and at most 1 (%s)\n", argv[i]);
+                return 1;
+            }
+
+            setRenderScale(renderScale);
+        } else if (!strcmp(argv[i], "--trail") && i + 1 < argc) {
+            int trailLength = atoi(argv[++i]);
+
+            if (trailLength < 0 || trailLength > TRAIL_MAX_LENGTH) {
+                printf("The trail must have between 0 and %d positions (%s)\n", TRAIL_MAX_LENGTH, argv[i]);
+                return 1;
+            }
+
+            setTrailLength(trailLength);
+        } else {
+            printf("Unknown option (%s)\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // The suns move in the N-body mode, so the static objects can't be kept
+    if (dirtyRects && nBody) {
+        printf("The dirty rectangles mode is ignored in the N-body mode\n");
+    }
+
+    setDirtyRectanglesMode(dirtyRects && !nBody);
+
+    // First configuration file parsing, in the background while the window is created
+    startPlaylist(nbLevels, argv + 1);
+
+    initializeWindow();
+
+    Game * level = takeNextLevel();
+
+    if (level == NULL) {
+        SDL_Quit();
+        return 1;
+    }
+
+    Game game = *level;
+    free(level);
+
+    // Distance of the gravity pulls
+    setGravityCutoff(&game, gravityCutoff);
+
+    // Mutual pulls of all the bodies
+    if (nBody) {
+        nBody = startNBody(&game);
+        setOrbitsShowing(!nBody);
+
+        // Same cutoff for the next levels
+        gravityCutoff = game.gravityCutoff;
+    }
+
+    // Configuration file watching
+    if (hotReload) {
+        startConfigWatcher(getCurrentLevelPath());
+    }
+
+    // Hardware counters opening
+    if (perfCounters) {
+        startProfiler();
+    }
+
+    // Shared memory segment read by the external tools
+    bool telemetry = telemetryName != NULL && startTelemetry(telemetryName);
 
     // Window initialization
-    initializeRenderer();
+    initializeRenderer(&game);
 
     // Initial universe display
-    printActualState();
+    printActualState(&game);
 
     // Time starting
-    startTime();
+    startTime(&game);
+
+    // Recording of the ticks and keyframes (the N-body mode can't be simulated again from a keyframe)
+    bool timeline = !nBody;
+
+    if (timeline) {
+        startTimeline(&game);
+    }
 
     int lastUpdateTime = SDL_GetTicks();
+    Uint64 lastFrameCounter = SDL_GetPerformanceCounter();
 
     bool stopGame = false;
     bool gameStarted = false;
 
+    // Time of the collision of the spaceship (-1 while it flies)
+    int explosionStart = -1;
+
+    // Ticks per frame (0 for as many as possible), and fraction of tick carried over to the next frame
+    double timeScales[] = {0.25, 0.5, 1, 2, 5, 10, 25, 50, 100, 0};
+    int nbTimeScales = sizeof(timeScales) / sizeof(timeScales[0]);
+    int timeScaleIndex = 2;
+    double tickCredit = 0;
+
     // Game loop
     while (!stopGame) {
         SDL_Event event;
 
+        beginProfiledPhase();
+
         // Keyboard events listening
         while (SDL_PollEvent(&event)) {
             switch (event.type) {
@@ -52,7 +277,8 @@ int main(int argc, char * argv[]) {
                         case SDLK_SPACE : {
                             if (!gameStarted) {
                                 gameStarted = true;
-                                startGame();
+                                startGame(&game);
+                                recordGameStart();
                             }
                             
                             break;
@@ -63,13 +289,96 @@ int main(int argc, char * argv[]) {
                             break;
                         }
 
+                        case SDLK_PLUS :
+                        case SDLK_EQUALS :
+                        case SDLK_KP_PLUS : {
+                            if (timeScaleIndex < nbTimeScales - 1) timeScaleIndex++;
+                            printTimeScale(timeScales[timeScaleIndex]);
+                            break;
+                        }
+
+                        case SDLK_MINUS :
+                        case SDLK_KP_MINUS : {
+                            if (timeScaleIndex > 0) timeScaleIndex--;
+                            printTimeScale(timeScales[timeScaleIndex]);
+                            break;
+                        }
+
+                        case SDLK_h : {
+                            permuteHeatmapShowing();
+                            break;
+                        }
+
+                        case SDLK_F3 : {
+                            permuteHudShowing();
+                            break;
+                        }
+
+                        case SDLK_F5 : {
+                            if (saveSnapshotFile(&game, SNAPSHOT_PATH)) {
+                                printf("Game saved (%s)\n", SNAPSHOT_PATH);
+                            }
+
+                            break;
+                        }
+
+                        case SDLK_F9 : {
+                            if (loadSnapshotFile(&game, SNAPSHOT_PATH)) {
+                                // A snapshot saved before the launch waits for SPACE again (the speeds are only set by startGame())
+                                gameStarted = getConfiguration(&game).spaceship.maxSpeed > 0;
+                                explosionStart = -1;
+                                resetStaticObjects(&game);
+
+                                if (nBody) loadNBodies(&game);
+                                if (timeline) startTimeline(&game);
+                            }
+
+                            break;
+                        }
+
+                        case SDLK_HOME : {
+                            if (timeline) {
+                                gameStarted = goToTick(&game, 0);
+                                explosionStart = -1;
+                            }
+
+                            break;
+                        }
+
+                        case SDLK_PAGEUP : {
+                            if (timeline) {
+                                gameStarted = goToTick(&game, getTimelineTick() - SEEK_TICKS);
+                                explosionStart = -1;
+                            }
+
+                            break;
+                        }
+
+                        case SDLK_PAGEDOWN : {
+                            if (timeline) {
+                                gameStarted = goToTick(&game, getTimelineTick() + SEEK_TICKS);
+                                explosionStart = -1;
+                            }
+
+                            break;
+                        }
+
+                        case SDLK_END : {
+                            if (timeline) {
+                                gameStarted = goToTick(&game, getTimelineLength());
+                                explosionStart = -1;
+                            }
+
+                            break;
+                        }
+
                         case SDLK_LEFT : {
-                            startTurningLeft();
+                            startTurningLeft(&game);
                             break;
                         }
 
                         case SDLK_RIGHT : {
-                            startTurningRight();
+                            startTurningRight(&game);
                             break;
                         }
                     }
@@ -79,12 +388,12 @@ int main(int argc, char * argv[]) {
                 case SDL_KEYUP : {
                     switch (event.key.keysym.sym) {
                         case SDLK_LEFT : {
-                            stopTurningLeft();
+                            stopTurningLeft(&game);
                             break;
                         }
 
                         case SDLK_RIGHT : {
-                            stopTurningRight();
+                            stopTurningRight(&game);
                             break;
                         }
                     }
@@ -93,36 +402,144 @@ int main(int argc, char * argv[]) {
             }
         }
 
+        endProfiledPhase(EVENTS_PROFILE);
+
         int currentTime = SDL_GetTicks();
 
         // If we are in the updating delay
         if (currentTime - lastUpdateTime >= FPS) {
+            // Frame time measuring for the HUD
+            Uint64 frameCounter = SDL_GetPerformanceCounter();
+            recordFrameTime((frameCounter - lastFrameCounter) * 1000.0 / SDL_GetPerformanceFrequency());
+            lastFrameCounter = frameCounter;
+
+            // Changes of the configuration file applying
+            if (hotReload && applyConfigChanges(&game)) {
+                resetStaticObjects(&game);
+
+                if (nBody) loadNBodies(&game);
+                if (timeline) startTimeline(&game);
+            }
+
             // Actual state of the universe display
-            printActualState();
+            beginProfiledPhase();
+            printActualState(&game);
+            endProfiledPhase(RENDER_PROFILE);
 
-            // Planets rotations
-            rotatePlanets();
+            // While the spaceship explodes, only the particles move
+            if (explosionStart >= 0) {
+                if (currentTime - explosionStart >= EXPLOSION_DURATION) {
+                    stopGame = true;
+                }
 
-            // Spaceship moving
-            moveSpaceship();
+                lastUpdateTime = currentTime;
+                continue;
+            }
 
-            //mise à jour du titre et des FPS
-            updateTitle(currentTime, lastUpdateTime);
-
-            // Winning and losing conditions checking
-            if (isGameWin()) {
-                printf("Well played ! Score : %d\n", getConfiguration().score);
-                stopGame = true;
-            } else if (isGameLost()) {
-                stopGame = true;
+            // Number of ticks simulated during this frame
+            int nbTicks = INT_MAX;
+
+            if (timeScales[timeScaleIndex] > 0) {
+                tickCredit += timeScales[timeScaleIndex];
+                nbTicks = tickCredit;
+                tickCredit -= nbTicks;
+            }
+
+            Uint64 physicsStart = SDL_GetPerformanceCounter();
+            Uint64 physicsBudget = PHYSICS_BUDGET * SDL_GetPerformanceFrequency() / 1000;
+
+            beginProfiledPhase();
+
+            // Only the last state of the frame is displayed
+            for (int tick = 0; tick < nbTicks; tick++) {
+                // The ticks that don't fit in the frame are dropped: the game slows down rather than freezing
+                if (tick > 0 && SDL_GetPerformanceCounter() - physicsStart > physicsBudget) break;
+
+                // Time of the game going by
+                advanceTime(&game, currentTime - lastUpdateTime);
+
+                // Planets rotations, or moves of all the bodies pulling each other
+                if (nBody) {
+                    stepNBody(&game);
+                } else {
+                    rotatePlanets(&game);
+                }
+
+                // Spaceship moving
+                moveSpaceship(&game);
+
+                if (timeline) recordTick(&game);
+
+                if (telemetry) {
+                    publishTelemetry(&game, getLastPhaseTime(PHYSICS_PHASE), getLastPhaseTime(RENDER_PHASE), getLastPhaseTime(PRESENT_PHASE));
+                }
+
+                // Winning and losing conditions checking
+                if (isGameWin(&game)) {
+                    printf("Well played ! Score : %d\n", getConfiguration(&game).score);
+
+                    // Next level of the playlist, already parsed while this one was played
+                    if (goToNextLevel(&game, gravityCutoff)) {
+                        if (hotReload) {
+                            stopConfigWatcher();
+                            startConfigWatcher(getCurrentLevelPath());
+                        }
+
+                        resetStaticObjects(&game);
+                        startTime(&game);
+
+                        if (nBody) loadNBodies(&game);
+                        if (timeline) startTimeline(&game);
+
+                        gameStarted = false;
+                    } else {
+                        stopGame = true;
+                    }
+
+                    break;
+                } else if (isGameLost(&game)) {
+                    explosionStart = currentTime;
+                    emitExplosionParticles(&game);
+                    break;
+                }
             }
 
+            endProfiledPhase(PHYSICS_PROFILE);
+            recordPhaseTime(PHYSICS_PHASE, (SDL_GetPerformanceCounter() - physicsStart) * 1000.0 / SDL_GetPerformanceFrequency());
+
+            //mise à jour du titre et des FPS
+            updateTitle(&game, currentTime, lastUpdateTime);
+
             lastUpdateTime = currentTime;
         }
     }
 
+    // Configuration file watching stopping
+    if (hotReload) {
+        stopConfigWatcher();
+    }
+
+    // Level loading stopping
+    stopPlaylist();
+
+    // Durations of the N-body steps printing
+    if (nBody) {
+        stopNBody();
+    }
+
+    // Recorded timeline freeing
+    freeTimeline();
+
+    // Telemetry segment removing
+    if (telemetry) {
+        stopTelemetry();
+    }
+
+    // Counts of the main loop phases printing
+    stopProfiler();
+
     // Dynamically allocated memories freeing
-    freeAllocations();
+    freeAllocations(&game);
 
     // SDL objects freeing
     freeSDL();
@@ -10,11 +10,20 @@
 #define SPACESHIP_INITIAL_SPEED 4
 #define G 1000
 
-Configuration configuration;
-clock_t startingTime;
+// Alignment of the allocations made in an arena
+#define ARENA_ALIGNMENT 16
 
-bool leftKeyPressed  = false;
-bool rightKeyPressed = false;
+// Margin added to the gravity cutoff when listing the neighbors of the spaceship
+#define NEIGHBOR_SKIN 64
+
+// Fraction of the gravity cutoff from which the pulls start to fade
+#define GRAVITY_TAPER_START ((Real) 0.8)
+
+// Newton iterations solving Kepler's equation, the same for every orbit (precise enough up to an eccentricity of 0.99)
+#define KEPLER_ITERATIONS 6
+
+// Number of elliptical orbits solved together
+#define KEPLER_BATCH 64
 
 typedef struct {
     char * keyword;
@@ -28,19 +37,23 @@ typedef struct {
     int followingKeyWordsLength;
 } Information;
 
-char * globalPreviousWords[9][2] = {{""}, {""}, {"START"}, {""}, {""}, {"STAR_POS"}, {"STAR_RADIUS"}, {"NB_PLANET", "PLANET_ORBIT"}, {"PLANET_RADIUS"}};
-char * globalFollowingWords[9][2] = {{""},{"END"},{""},{""},{"STAR_RADIUS"},{"NB_PLANET"},{"PLANET_RADIUS", ""},{"PLANET_ORBIT"},{"PLANET_RADIUS", ""}};
+char * globalPreviousWords[13][5] = {{""}, {""}, {"START"}, {""}, {""}, {"STAR_POS"}, {"STAR_RADIUS"}, {"NB_PLANET", "PLANET_ORBIT", "PLANET_ECCENTRICITY", "PLANET_PERIAPSIS", "PLANET_PHASE"}, {"PLANET_RADIUS"}, {"WIN_SIZE"}, {"PLANET_ORBIT"}, {"PLANET_ORBIT", "PLANET_ECCENTRICITY"}, {"PLANET_ORBIT", "PLANET_ECCENTRICITY", "PLANET_PERIAPSIS"}};
+char * globalFollowingWords[13][5] = {{"", "WORLD_SIZE"},{"END"},{""},{""},{"STAR_RADIUS"},{"NB_PLANET"},{"PLANET_RADIUS", ""},{"PLANET_ORBIT"},{"PLANET_RADIUS", "", "PLANET_ECCENTRICITY", "PLANET_PERIAPSIS", "PLANET_PHASE"},{""},{"PLANET_RADIUS", "", "PLANET_PERIAPSIS", "PLANET_PHASE"},{"PLANET_RADIUS", "", "PLANET_PHASE"},{"PLANET_RADIUS", ""}};
 
 Information informationDictionary[] = {
-    {"WIN_SIZE"       , 2, false, globalPreviousWords[0], 1, globalFollowingWords[0], 1},
-    {"START"          , 2, false, globalPreviousWords[1], 1, globalFollowingWords[1], 1},
-    {"END"            , 2, false, globalPreviousWords[2], 1, globalFollowingWords[2], 1},
-    {"NB_SOLAR_SYSTEM", 1, false, globalPreviousWords[3], 1, globalFollowingWords[3], 1},
-    {"STAR_POS"       , 2, false, globalPreviousWords[4], 1, globalFollowingWords[4], 1},
-    {"STAR_RADIUS"    , 1, false, globalPreviousWords[5], 1, globalFollowingWords[5], 1},
-    {"NB_PLANET"      , 1, false, globalPreviousWords[6], 1, globalFollowingWords[6], 2},
-    {"PLANET_RADIUS"  , 1, false, globalPreviousWords[7], 2, globalFollowingWords[7], 1},
-    {"PLANET_ORBIT"   , 1, true , globalPreviousWords[8], 1, globalFollowingWords[8], 2}
+    {"WIN_SIZE"           , 2, false, globalPreviousWords[0] , 1, globalFollowingWords[0] , 2},
+    {"START"              , 2, false, globalPreviousWords[1] , 1, globalFollowingWords[1] , 1},
+    {"END"                , 2, false, globalPreviousWords[2] , 1, globalFollowingWords[2] , 1},
+    {"NB_SOLAR_SYSTEM"    , 1, false, globalPreviousWords[3] , 1, globalFollowingWords[3] , 1},
+    {"STAR_POS"           , 2, false, globalPreviousWords[4] , 1, globalFollowingWords[4] , 1},
+    {"STAR_RADIUS"        , 1, false, globalPreviousWords[5] , 1, globalFollowingWords[5] , 1},
+    {"NB_PLANET"          , 1, false, globalPreviousWords[6] , 1, globalFollowingWords[6] , 2},
+    {"PLANET_RADIUS"      , 1, false, globalPreviousWords[7] , 5, globalFollowingWords[7] , 1},
+    {"PLANET_ORBIT"       , 1, true , globalPreviousWords[8] , 1, globalFollowingWords[8] , 5},
+    {"WORLD_SIZE"         , 2, false, globalPreviousWords[9] , 1, globalFollowingWords[9] , 1},
+    {"PLANET_ECCENTRICITY", 1, false, globalPreviousWords[10], 1, globalFollowingWords[10], 4},
+    {"PLANET_PERIAPSIS"   , 1, true , globalPreviousWords[11], 2, globalFollowingWords[11], 3},
+    {"PLANET_PHASE"       , 1, true , globalPreviousWords[12], 3, globalFollowingWords[12], 2}
 };
 
 /**
@@ -112,15 +125,13 @@ bool checkNbCharacterOccurencies(char * path, char character, int nbMax) {
 }
 
 /**
- * Returns the first word of a string
+ * Copy the first word of a string
  * 
  * @param input The string
- * 
- * @return The first word of the string
+ * @param output Buffer receiving the first word (at least as long as the string)
 */
-char * getFirstWord(char * input) {
+void getFirstWord(char * input, char * output) {
     int len = strlen(input);
-    char * output = (char *) malloc(len + 1);
 
     int i;
 
@@ -131,8 +142,6 @@ char * getFirstWord(char * input) {
 
     // Ending the output string
     output[i] = '\0';
-
-    return output;
 }
 
 /**
@@ -185,17 +194,20 @@ bool areLinesOK(char * path) {
             int nbSpace = 1;
 
             // Cutting out of the first word
-            char * firstWord = getFirstWord(line);
+            char firstWord[256];
+            getFirstWord(line, firstWord);
+
+            Information information = findInformation(firstWord);
 
             // Checking if the first word is known
-            if (findInformation(firstWord).nbParameters == -1) {
+            if (information.nbParameters == -1) {
                 printf("Some first words of lines are unknown\n");
                 fclose(file);
                 return false;
             }
 
             // Stores in a variable whether a row's parameters can be negative or not
-            bool parametersCanBeNegative = findInformation(getFirstWord(line)).parametersCanBeNegative;
+            bool parametersCanBeNegative = information.parametersCanBeNegative;
 
             // Iterate through all the characters of the line folowing the first word
             while (line[i] != '\n' && line[i] != '\0') {
@@ -220,7 +232,7 @@ bool areLinesOK(char * path) {
             }
 
             // Checking if we found the correct number of parameters
-            if (nbSpace != findInformation(getFirstWord(line)).nbParameters) {
+            if (nbSpace != information.nbParameters) {
                 printf("Some lines do not have the correct number of parameters\n");
                 fclose(file);
                 return false;
@@ -250,13 +262,11 @@ bool isLinesOrderOK(char * path) {
 
     // Iterate through all the lines of the file
     while (fgets(newLine, sizeof(newLine), file) != NULL) {
-        strcpy(newLine, getFirstWord(newLine));
-
         strcpy(previousFirstWord, currentFirstWord);
         strcpy(currentFirstWord, followingFirstWord);
-        strcpy(followingFirstWord, newLine);
+        getFirstWord(newLine, followingFirstWord);
 
-        Information attribute = findInformation(getFirstWord(currentFirstWord));
+        Information attribute = findInformation(currentFirstWord);
 
         if (attribute.nbParameters == -1) continue;
 
@@ -308,18 +318,21 @@ bool isConfigurationFileOK(char * path) {
 }
 
 /**
- * Checks that a position is in the frame
+ * Checks that a position is in the world
  * 
+ * @param game Game whose world is used
  * @param position Checked Position
  * 
  * @return True if everything is OK, false otherwise
 */
-bool checkPositionInFrame(Position position) {
+bool checkPositionInFrame(Game * game, Position position) {
+    Configuration * configuration = &game->configuration;
+
     return !(
         position.posX < 0 ||
-        position.posX > configuration.winWidth ||
+        position.posX > configuration->worldWidth ||
         position.posY < 0 ||
-        position.posY > configuration.winHeight
+        position.posY > configuration->worldHeight
     );
 }
 
@@ -331,165 +344,818 @@ bool checkPositionInFrame(Position position) {
  * @return True if everything is OK, false otherwise
 */
 bool checkPlanetPosition(Sun sun, Planet planet) {
-    return !(sun.position.posY - abs(planet.orbit) < 0);
+    return !(sun.position.posY - getOrbitReach(planet) < 0);
+}
+
+/**
+ * Read an optional line of the configuration file (nothing is read if the next line starts with another keyword)
+ * 
+ * @param configFile Open configuration file
+ * @param keyword First word of the line
+ * @param value Receives the parameter of the line if it is read
+ * 
+ * @return True if the line was read, false otherwise
+*/
+bool readOptionalLine(FILE * configFile, char * keyword, int * value) {
+    long start = ftell(configFile);
+
+    char line[256];
+    char firstWord[256];
+
+    if (fgets(line, sizeof(line), configFile) != NULL) {
+        getFirstWord(line, firstWord);
+
+        if (!strcmp(firstWord, keyword) && sscanf(line + strlen(keyword), "%d", value) == 1) {
+            // Skipping the empty lines, like the other readings
+            fscanf(configFile, " ");
+            return true;
+        }
+    }
+
+    // Going back to the beginning of the line
+    fseek(configFile, start, SEEK_SET);
+    return false;
+}
+
+/**
+ * Read the optional lines describing an elliptical orbit after the orbit of a planet
+ * 
+ * @param configFile Open configuration file
+ * @param planet Planet whose orbit is read
+ * 
+ * @return True if the orbit is valid, false otherwise
+*/
+bool readOrbitShape(FILE * configFile, Planet * planet) {
+    int eccentricity = 0;
+    int periapsis = 0;
+    int phase = 0;
+
+    // Eccentricity in percents, angles in degrees
+    readOptionalLine(configFile, "PLANET_ECCENTRICITY", &eccentricity);
+    readOptionalLine(configFile, "PLANET_PERIAPSIS", &periapsis);
+    readOptionalLine(configFile, "PLANET_PHASE", &phase);
+
+    if (eccentricity > 99) return false;
+
+    planet->eccentricity = eccentricity / 100.0;
+    planet->periapsis = periapsis % 360 * M_PI / 180;
+    planet->phase = (phase % 360 + 360) % 360 * M_PI / 180;
+
+    // Same angle origin as the circular orbits (the top of the sun)
+    planet->periapsisX = cos(planet->periapsis - 0.5 * M_PI);
+    planet->periapsisY = sin(planet->periapsis - 0.5 * M_PI);
+
+    return true;
+}
+
+/**
+ * Reserve the single block of memory of an arena
+ * 
+ * @param arena The arena
+ * @param size Size of the block
+ * 
+ * @return True if the block was reserved, false otherwise
+*/
+bool createArena(Arena * arena, size_t size) {
+    arena->memory = calloc(size > 0 ? size : 1, 1);
+    arena->size = size;
+    arena->used = 0;
+
+    return arena->memory != NULL;
+}
+
+/**
+ * Slice memory off an arena
+ * 
+ * @param arena The arena
+ * @param size Size of the allocation
+ * 
+ * @return Zeroed memory, or NULL if the arena is full
+*/
+void * allocateFromArena(Arena * arena, size_t size) {
+    size_t start = (arena->used + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+
+    if (arena->memory == NULL || start + size > arena->size) return NULL;
+
+    arena->used = start + size;
+
+    return arena->memory + start;
+}
+
+/**
+ * Free all the allocations of an arena at once
+ * 
+ * @param arena The arena
+*/
+void freeArena(Arena * arena) {
+    free(arena->memory);
+
+    Arena emptyArena = {0};
+    *arena = emptyArena;
+}
+
+/**
+ * Calculate the size of an arena holding some allocations, with their alignment
+ * 
+ * @param size1 Size of the first allocation
+ * @param size2 Size of the second allocation
+ * @param nbAllocations2 Number of second allocations
+ * 
+ * @return Size of the arena
+*/
+size_t getArenaSize(size_t size1, size_t size2, int nbAllocations2) {
+    return size1 + ARENA_ALIGNMENT + nbAllocations2 * (size2 + ARENA_ALIGNMENT);
+}
+
+/**
+ * Reserve the memory of the solar systems and of all their planets in a single block
+ * 
+ * @param configuration Configuration receiving the solar systems list
+ * @param nbSolarSystems Number of solar systems
+ * @param nbPlanets Total number of planets
+ * 
+ * @return True if the memory was reserved, false otherwise
+*/
+bool allocateSolarSystems(Configuration * configuration, int nbSolarSystems, int nbPlanets) {
+    // Each planets list is aligned on its own
+    size_t size = getArenaSize(nbSolarSystems * sizeof(SolarSystem), sizeof(Planet), nbPlanets);
+
+    if (!createArena(&configuration->bodiesArena, size)) return false;
+
+    configuration->solarSystems = allocateFromArena(&configuration->bodiesArena, nbSolarSystems * sizeof(SolarSystem));
+
+    return true;
+}
+
+/**
+ * Take the planets list of a solar system from the memory reserved by allocateSolarSystems
+ * 
+ * @param configuration Configuration owning the memory
+ * @param nbPlanets Number of planets of the list
+ * 
+ * @return Zeroed planets list, or NULL if more planets than reserved are asked for
+*/
+Planet * allocatePlanets(Configuration * configuration, int nbPlanets) {
+    return allocateFromArena(&configuration->bodiesArena, nbPlanets * sizeof(Planet));
+}
+
+/**
+ * Count the planets announced in the rest of a configuration file (first reading, before any allocation)
+ * 
+ * @param file Open configuration file, left at the same position
+ * @param nbSolarSystems Number of solar systems that will be read
+ * 
+ * @return Total number of planets of these solar systems
+*/
+int countPlanets(FILE * file, int nbSolarSystems) {
+    long start = ftell(file);
+
+    char line[256];
+    int nbPlanetsOfSystem;
+
+    int nbPlanets = 0;
+    int nbReadSolarSystems = 0;
+
+    // Iterate through all the lines of the file, until the last solar system that will be read
+    while (nbReadSolarSystems < nbSolarSystems && fgets(line, sizeof(line), file) != NULL) {
+        if (sscanf(line, "NB_PLANET %d", &nbPlanetsOfSystem) == 1) {
+            nbPlanets += nbPlanetsOfSystem;
+            nbReadSolarSystems++;
+        }
+    }
+
+    fseek(file, start, SEEK_SET);
+    return nbPlanets;
 }
 
 /**
  * Read the configuration file to create the configuration of the game
  * 
+ * @param game Game to initialize
  * @param path Path of the configuration file
+ * 
+ * @return True if the configuration was loaded, false otherwise
 */
-void loadConfigFile(char * path) {
+bool loadConfigFile(Game * game, char * path) {
+    Configuration * configuration = &game->configuration;
+
+    // Fresh game (not started, no key pressed, seeded with the current time)
+    Game emptyGame = {0};
+    *game = emptyGame;
+
+    setSeed(game, time(NULL));
+
     // Configuration file opening
     FILE * configFile = getOpenFile(path);
 
     // Ensure configuration file's openability
     if (configFile == NULL) {
         printf("Can't open configuration file (%s).\n", path);
-        exit(1);
+        return false;
     }
 
     // Ensure configuration file's structure
     if (!isConfigurationFileOK(path)) {
         printf("Configuration file error (%s).\n", path);
-        exit(1);
+        fclose(configFile);
+        return false;
     }
 
     // Window dimensions
-    fscanf(configFile, "WIN_SIZE %d %d\n", &configuration.winWidth, &configuration.winHeight);
+    fscanf(configFile, "WIN_SIZE %d %d\n", &configuration->winWidth, &configuration->winHeight);
+
+    // World dimensions (the window's ones if not given)
+    if (fscanf(configFile, "WORLD_SIZE %d %d\n", &configuration->worldWidth, &configuration->worldHeight) != 2) {
+        configuration->worldWidth  = configuration->winWidth;
+        configuration->worldHeight = configuration->winHeight;
+    }
+
+    if (configuration->worldWidth < configuration->winWidth || configuration->worldHeight < configuration->winHeight) {
+        printf("The world can't be smaller than the window\n");
+        fclose(configFile);
+        return false;
+    }
 
     // Starting point
-    fscanf(configFile, "START %le %le\n", &configuration.startingPoint.posX, &configuration.startingPoint.posY);
+    double posX, posY;
+
+    fscanf(configFile, "START %le %le\n", &posX, &posY);
+    configuration->startingPoint = (Position) {posX, posY};
 
-    if (!checkPositionInFrame((Position) {configuration.startingPoint.posX, configuration.startingPoint.posY})) {
+    if (!checkPositionInFrame(game, (Position) {configuration->startingPoint.posX, configuration->startingPoint.posY})) {
         printf("The starting point is outside of the frame\n");
         fclose(configFile);
-        exit(1);
+        return false;
     }
 
     // Arrival point
-    fscanf(configFile, "END %le %le\n", &configuration.arrivalPoint.posX, &configuration.arrivalPoint.posY);
+    fscanf(configFile, "END %le %le\n", &posX, &posY);
+    configuration->arrivalPoint = (Position) {posX, posY};
 
-    if (!checkPositionInFrame((Position) {configuration.arrivalPoint.posX, configuration.arrivalPoint.posY})) {
+    if (!checkPositionInFrame(game, (Position) {configuration->arrivalPoint.posX, configuration->arrivalPoint.posY})) {
         printf("The arrival point is outside of the frame\n");
         fclose(configFile);
-        exit(1);
+        return false;
     }
 
     Spaceship spaceship = {0};
-    configuration.spaceship = spaceship;
+    configuration->spaceship = spaceship;
 
     // Initial spaceship position (on the starting point)
-    configuration.spaceship.position = configuration.startingPoint;
+    configuration->spaceship.position = configuration->startingPoint;
 
     // Spaceship's weight
-    configuration.spaceship.weight = SPACESHIP_WEIGHT;
+    configuration->spaceship.weight = SPACESHIP_WEIGHT;
 
     // Number of solar systemes reading
-    fscanf(configFile, "NB_SOLAR_SYSTEM %d\n", &configuration.nbSolarSystems);
+    fscanf(configFile, "NB_SOLAR_SYSTEM %d\n", &configuration->nbSolarSystems);
 
-    // Solar systems list
-    configuration.solarSystems = malloc(configuration.nbSolarSystems * sizeof(SolarSystem));
+    // Solar systems and planets lists, in a single block sized by a first reading of the file
+    int nbPlanets = countPlanets(configFile, configuration->nbSolarSystems);
+
+    if (!allocateSolarSystems(configuration, configuration->nbSolarSystems, nbPlanets)) {
+        printf("Not enough memory for the solar systems\n");
+        configuration->nbSolarSystems = 0;
+        fclose(configFile);
+        return false;
+    }
 
     // Iterate through all the solar systems
-    for (int i = 0; i < configuration.nbSolarSystems; i++) {
+    for (int i = 0; i < configuration->nbSolarSystems; i++) {
         // Including the sun in the spacial objects counter
-        configuration.nbStars++;
+        configuration->nbStars++;
 
         // Sun's attributes
-        if (fscanf(configFile, "STAR_POS %le %le\n", &configuration.solarSystems[i].sun.position.posX, &configuration.solarSystems[i].sun.position.posY) != 2) {
-            printf("Waited for %d solar systems but only got %d\n", configuration.nbSolarSystems, i);
+        if (fscanf(configFile, "STAR_POS %le %le\n", &posX, &posY) != 2) {
+            printf("Waited for %d solar systems but only got %d\n", configuration->nbSolarSystems, i);
             fclose(configFile);
-            exit(1);
+            freeAllocations(game);
+            return false;
         }
-        fscanf(configFile, "STAR_RADIUS %d\n", &configuration.solarSystems[i].sun.radius);
+        configuration->solarSystems[i].sun.position = (Position) {posX, posY};
 
-        if (!checkPositionInFrame(configuration.solarSystems[i].sun.position)) {
+        fscanf(configFile, "STAR_RADIUS %d\n", &configuration->solarSystems[i].sun.radius);
+
+        if (!checkPositionInFrame(game, configuration->solarSystems[i].sun.position)) {
             printf("A sun is outside of the frame\n");
             fclose(configFile);
-            exit(1);
+            freeAllocations(game);
+            return false;
         }
 
         // Number of planets reading
-        fscanf(configFile, "NB_PLANET %d\n", &configuration.solarSystems[i].nbPlanets);
+        fscanf(configFile, "NB_PLANET %d\n", &configuration->solarSystems[i].nbPlanets);
 
         // Planets list
-        configuration.solarSystems[i].planets = malloc(configuration.solarSystems[i].nbPlanets * sizeof(Planet));
+        configuration->solarSystems[i].planets = allocatePlanets(configuration, configuration->solarSystems[i].nbPlanets);
+
+        if (configuration->solarSystems[i].planets == NULL) {
+            printf("More planets than announced in the n°%d solar system\n", i + 1);
+            fclose(configFile);
+            freeAllocations(game);
+            return false;
+        }
 
         // Iterate through all the planets
-        for (int j = 0; j < configuration.solarSystems[i].nbPlanets; j++) {
+        for (int j = 0; j < configuration->solarSystems[i].nbPlanets; j++) {
             // Including the planet in the spacial objects counter
-            configuration.nbStars++;
+            configuration->nbStars++;
 
             // Planet's attributes
-            if (fscanf(configFile, "PLANET_RADIUS %d PLANET_ORBIT %d\n", &configuration.solarSystems[i].planets[j].radius, &configuration.solarSystems[i].planets[j].orbit) != 2) {
-                printf("Waited for %d planets in the n°%d solar system but only got %d\n", configuration.solarSystems[i].nbPlanets, i + 1, j);
+            if (fscanf(configFile, "PLANET_RADIUS %d PLANET_ORBIT %d\n", &configuration->solarSystems[i].planets[j].radius, &configuration->solarSystems[i].planets[j].orbit) != 2) {
+                printf("Waited for %d planets in the n°%d solar system but only got %d\n", configuration->solarSystems[i].nbPlanets, i + 1, j);
                 fclose(configFile);
-                exit(1);
+                freeAllocations(game);
+                return false;
+            }
+
+            if (!readOrbitShape(configFile, &configuration->solarSystems[i].planets[j])) {
+                printf("An orbit is too eccentric (at most 99%%)\n");
+                fclose(configFile);
+                freeAllocations(game);
+                return false;
             }
         
-            if (!checkPlanetPosition(configuration.solarSystems[i].sun, configuration.solarSystems[i].planets[j])) {
+            if (!checkPlanetPosition(configuration->solarSystems[i].sun, configuration->solarSystems[i].planets[j])) {
                 printf("A planet is gonna leave the frame\n");
                 fclose(configFile);
-                exit(1);
+                freeAllocations(game);
+                return false;
             }
         }
     }
 
     // Configuration file closing
     fclose(configFile);
+
+    buildChunks(game);
+
+    return true;
+}
+
+/**
+ * Calculate the chunks ranges covering a segment of the toric world, along one axis
+ * 
+ * @param center Center of the segment
+ * @param reach Half of the length of the segment
+ * @param worldSize Size of the world along the axis
+ * @param nbChunks Number of chunks along the axis
+ * @param ranges First and last chunks of each range
+ * 
+ * @return Number of ranges (2 if the segment goes across the edge of the world)
+*/
+int getChunkRanges(double center, double reach, int worldSize, int nbChunks, int ranges[2][2]) {
+    if (2 * reach >= worldSize) {
+        ranges[0][0] = 0;
+        ranges[0][1] = nbChunks - 1;
+        return 1;
+    }
+
+    double first = fmod(center - reach, worldSize);
+    if (first < 0) first += worldSize;
+
+    double last = first + 2 * reach;
+
+    ranges[0][0] = first / CHUNK_SIZE;
+
+    if (last < worldSize) {
+        ranges[0][1] = last / CHUNK_SIZE;
+        return 1;
+    }
+
+    // The segment goes on from the other side of the world
+    ranges[0][1] = nbChunks - 1;
+    ranges[1][0] = 0;
+    ranges[1][1] = (last - worldSize) / CHUNK_SIZE;
+
+    // Both ends in the same chunk, or in neighboring ones: the whole axis, each chunk once
+    if (ranges[1][1] >= ranges[0][0] - 1) {
+        ranges[0][0] = 0;
+        return 1;
+    }
+
+    return 2;
+}
+
+// Steps of the chunks building
+typedef enum {
+    COUNT_REFERENCES,
+    COUNT_CHUNKS_BODIES,
+    FILL_CHUNKS
+} ChunksPass;
+
+/**
+ * Add a body to all the chunks covered by its bounding box, on both sides of the edges it crosses
+ * 
+ * @param configuration Configuration owning the chunks
+ * @param body The body
+ * @param center Center of the body's bounding box
+ * @param halfSize Half of the side of the body's bounding box
+ * @param pass Step of the chunks building (counting of all the references, counting per chunk, or filling)
+ * @param nbReferences Total number of references to bodies, increased while counting
+*/
+void addBodyToChunks(Configuration * configuration, BodyReference body, Position center, int halfSize, ChunksPass pass, int * nbReferences) {
+    // The pulls go across the edges of the world, so the parts of the box beyond them are listed on the other side
+    int rangesX[2][2], rangesY[2][2];
+    int nbRangesX = getChunkRanges(center.posX, halfSize, configuration->worldWidth,  configuration->nbChunksX, rangesX);
+    int nbRangesY = getChunkRanges(center.posY, halfSize, configuration->worldHeight, configuration->nbChunksY, rangesY);
+
+    if (pass == COUNT_REFERENCES) {
+        for (int ry = 0; ry < nbRangesY; ry++) {
+            for (int rx = 0; rx < nbRangesX; rx++) {
+                *nbReferences += (rangesX[rx][1] - rangesX[rx][0] + 1) * (rangesY[ry][1] - rangesY[ry][0] + 1);
+            }
+        }
+
+        return;
+    }
+
+    // First chunk of the part inside the world, where the body is displayed
+    int firstX = floor((center.posX - halfSize) / CHUNK_SIZE);
+    int firstY = floor((center.posY - halfSize) / CHUNK_SIZE);
+
+    body.firstChunkX = firstX > 0 ? firstX : 0;
+    body.firstChunkY = firstY > 0 ? firstY : 0;
+
+    for (int ry = 0; ry < nbRangesY; ry++) {
+        for (int y = rangesY[ry][0]; y <= rangesY[ry][1]; y++) {
+            for (int rx = 0; rx < nbRangesX; rx++) {
+                for (int x = rangesX[rx][0]; x <= rangesX[rx][1]; x++) {
+                    Chunk * chunk = &configuration->chunks[y * configuration->nbChunksX + x];
+
+                    if (pass == FILL_CHUNKS) chunk->bodies[chunk->nbBodies] = body;
+
+                    chunk->nbBodies++;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Free the chunks of a configuration
+ * 
+ * @param configuration The configuration
+*/
+void freeChunks(Configuration * configuration) {
+    freeArena(&configuration->chunksArena);
+
+    configuration->chunks = NULL;
+    configuration->nbChunksX = 0;
+    configuration->nbChunksY = 0;
+}
+
+/**
+ * Choose the variant of the spaceship moving fitting the bodies and the gravity cutoff
+ * 
+ * @param game The game
+*/
+void selectStepVariant(Game * game) {
+    Configuration * configuration = &game->configuration;
+
+    if (configuration->nbStars == 0) {
+        game->stepVariant = FREE_SPACE_STEP;
+        return;
+    }
+
+    game->stepVariant = GRAVITY_STEP;
+
+    // Without cutoff, the bodies always pull from across the edges
+    if (game->gravityCutoff <= 0) {
+        game->stepVariant = TOROIDAL_GRAVITY_STEP;
+        return;
+    }
+
+    double margin = game->gravityCutoff;
+
+    // Iterate through all the solar systems
+    for (int i = 0; i < configuration->nbSolarSystems; i++) {
+        SolarSystem solarSystem = configuration->solarSystems[i];
+
+        // Iterate through the sun and the orbits of the planets
+        for (int j = -1; j < solarSystem.nbPlanets; j++) {
+            int extent = j < 0 ? 0 : ceil(getOrbitReach(solarSystem.planets[j]));
+
+            // A body closer to an edge than the cutoff can pull from across it
+            if (
+                solarSystem.sun.position.posX - extent < margin ||
+                solarSystem.sun.position.posY - extent < margin ||
+                solarSystem.sun.position.posX + extent > configuration->worldWidth  - margin ||
+                solarSystem.sun.position.posY + extent > configuration->worldHeight - margin
+            ) {
+                game->stepVariant = TOROIDAL_GRAVITY_STEP;
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * Split the world in chunks and list in each of them the bodies that can be drawn there or pull from across an edge
+ * 
+ * A planet is listed in all the chunks covered by its orbit, so that the chunks never need to be updated while it moves
+ * 
+ * @param game The game
+*/
+void buildChunks(Game * game) {
+    Configuration * configuration = &game->configuration;
+
+    freeChunks(configuration);
+
+    configuration->nbChunksX = (configuration->worldWidth  + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    configuration->nbChunksY = (configuration->worldHeight + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    int nbChunks = configuration->nbChunksX * configuration->nbChunksY;
+    int nbReferences = 0;
+
+    for (ChunksPass pass = COUNT_REFERENCES; pass <= FILL_CHUNKS; pass++) {
+        // Iterate through all the solar systems
+        for (int i = 0; i < configuration->nbSolarSystems; i++) {
+            SolarSystem solarSystem = configuration->solarSystems[i];
+
+            addBodyToChunks(configuration, (BodyReference) {i, -1, 0, 0}, solarSystem.sun.position, solarSystem.sun.radius, pass, &nbReferences);
+
+            // Iterate through all the planets
+            for (int j = 0; j < solarSystem.nbPlanets; j++) {
+                Planet planet = solarSystem.planets[j];
+
+                addBodyToChunks(configuration, (BodyReference) {i, j, 0, 0}, solarSystem.sun.position, ceil(getOrbitReach(planet)) + planet.radius, pass, &nbReferences);
+            }
+        }
+
+        if (pass == COUNT_REFERENCES) {
+            // The chunks and all their lists in a single block
+            createArena(&configuration->chunksArena, getArenaSize(nbChunks * sizeof(Chunk), nbReferences * sizeof(BodyReference), 1));
+
+            configuration->chunks = allocateFromArena(&configuration->chunksArena, nbChunks * sizeof(Chunk));
+            BodyReference * references = allocateFromArena(&configuration->chunksArena, nbReferences * sizeof(BodyReference));
+
+            nbReferences = 0;
+
+            for (int i = 0; i < nbChunks; i++) {
+                configuration->chunks[i].bodies = references;
+            }
+        } else if (pass == COUNT_CHUNKS_BODIES) {
+            // Slicing of the lists, then filling from their start again
+            int offset = 0;
+
+            for (int i = 0; i < nbChunks; i++) {
+                configuration->chunks[i].bodies += offset;
+                offset += configuration->chunks[i].nbBodies;
+                configuration->chunks[i].nbBodies = 0;
+            }
+        }
+    }
+
+    // The neighbors of the spaceship refer to the bodies listed in the chunks
+    configuration->spaceship.neighbors.upToDate = false;
+
+    selectStepVariant(game);
+}
+
+/**
+ * Turn a seed into a state for the random numbers generator
+ * 
+ * @param seed The seed
+ * 
+ * @return Generator's state
+*/
+unsigned int mixSeed(unsigned int seed) {
+    // Mixing of the seed bits, so that close seeds give unrelated sequences
+    seed ^= seed >> 16;
+    seed *= 0x7FEB352D;
+    seed ^= seed >> 15;
+    seed *= 0x846CA68B;
+    seed ^= seed >> 16;
+
+    // A xorshift generator never leaves the zero state
+    return seed != 0 ? seed : 1;
+}
+
+/**
+ * Seed the random numbers generator of a game
+ * 
+ * @param game The game
+ * @param seed The seed
+*/
+void setSeed(Game * game, unsigned int seed) {
+    game->randomState = mixSeed(seed);
+}
+
+/**
+ * Draw a random number (xorshift generator)
+ * 
+ * @param state State of the generator, updated
+ * 
+ * @return Random number between 0 (included) and 1 (excluded)
+*/
+double getRandomNumber(unsigned int * state) {
+    unsigned int x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    *state = x;
+
+    return x / 4294967296.0;
+}
+
+/**
+ * Apply the differences of a new configuration to a running game, object by object
+ * 
+ * The spaceship, the score and the time are kept, and only the changed suns and planets are rewritten (the bodies are taken from the new configuration when their number changes)
+ * 
+ * @param game The running game
+ * @param newConfiguration The new configuration
+ * 
+ * @return Number of changed objects
+*/
+int updateConfiguration(Game * game, Configuration * newConfiguration) {
+    Configuration * configuration = &game->configuration;
+
+    int nbChanges = 0;
+
+    if (newConfiguration->winWidth != configuration->winWidth || newConfiguration->winHeight != configuration->winHeight) {
+        printf("The window size can't be changed while playing\n");
+    }
+
+    if (newConfiguration->worldWidth != configuration->worldWidth || newConfiguration->worldHeight != configuration->worldHeight) {
+        printf("The world size can't be changed while playing\n");
+    }
+
+    // Starting and arrival points
+    if (newConfiguration->startingPoint.posX != configuration->startingPoint.posX || newConfiguration->startingPoint.posY != configuration->startingPoint.posY) {
+        configuration->startingPoint = newConfiguration->startingPoint;
+        nbChanges++;
+    }
+
+    if (newConfiguration->arrivalPoint.posX != configuration->arrivalPoint.posX || newConfiguration->arrivalPoint.posY != configuration->arrivalPoint.posY) {
+        configuration->arrivalPoint = newConfiguration->arrivalPoint;
+        nbChanges++;
+    }
+
+    // Same number of solar systems and of planets in each of them: the bodies stay where they are in the arena
+    bool sameLayout = newConfiguration->nbSolarSystems == configuration->nbSolarSystems;
+
+    for (int i = 0; sameLayout && i < configuration->nbSolarSystems; i++) {
+        sameLayout = newConfiguration->solarSystems[i].nbPlanets == configuration->solarSystems[i].nbPlanets;
+    }
+
+    // Counting of the added and removed solar systems
+    int nbBodiesChanges = abs(newConfiguration->nbSolarSystems - configuration->nbSolarSystems);
+
+    int nbCommonSolarSystems = newConfiguration->nbSolarSystems < configuration->nbSolarSystems ? newConfiguration->nbSolarSystems : configuration->nbSolarSystems;
+
+    // Iterate through the solar systems of both configurations
+    for (int i = 0; i < nbCommonSolarSystems; i++) {
+        SolarSystem * solarSystem = &configuration->solarSystems[i];
+        SolarSystem newSolarSystem = newConfiguration->solarSystems[i];
+
+        if (newSolarSystem.sun.position.posX != solarSystem->sun.position.posX || newSolarSystem.sun.position.posY != solarSystem->sun.position.posY || newSolarSystem.sun.radius != solarSystem->sun.radius) {
+            if (sameLayout) solarSystem->sun = newSolarSystem.sun;
+            nbBodiesChanges++;
+        }
+
+        // Counting of the added and removed planets of this system
+        nbBodiesChanges += abs(newSolarSystem.nbPlanets - solarSystem->nbPlanets);
+
+        int nbCommonPlanets = newSolarSystem.nbPlanets < solarSystem->nbPlanets ? newSolarSystem.nbPlanets : solarSystem->nbPlanets;
+
+        // Iterate through the planets of both systems
+        for (int j = 0; j < nbCommonPlanets; j++) {
+            Planet newPlanet = newSolarSystem.planets[j];
+            Planet * planet = &solarSystem->planets[j];
+
+            if (newPlanet.radius != planet->radius || newPlanet.orbit != planet->orbit || newPlanet.eccentricity != planet->eccentricity || newPlanet.periapsis != planet->periapsis || newPlanet.phase != planet->phase) {
+                if (sameLayout) *planet = newPlanet;
+                nbBodiesChanges++;
+            }
+        }
+    }
+
+    // Otherwise the bodies blocks are exchanged, so that the old one is freed with the new configuration
+    if (!sameLayout) {
+        Arena bodiesArena = configuration->bodiesArena;
+        SolarSystem * solarSystems = configuration->solarSystems;
+        int nbSolarSystems = configuration->nbSolarSystems;
+
+        configuration->bodiesArena = newConfiguration->bodiesArena;
+        configuration->solarSystems = newConfiguration->solarSystems;
+        configuration->nbSolarSystems = newConfiguration->nbSolarSystems;
+        configuration->nbStars = newConfiguration->nbStars;
+
+        newConfiguration->bodiesArena = bodiesArena;
+        newConfiguration->solarSystems = solarSystems;
+        newConfiguration->nbSolarSystems = nbSolarSystems;
+    }
+
+    nbChanges += nbBodiesChanges;
+
+    // Placing of the changed planets at the current time
+    if (nbChanges > 0) {
+        rotatePlanets(game);
+        buildChunks(game);
+    }
+
+    return nbChanges;
 }
 
 /**
  * Start the timer used in the game
+ * 
+ * @param game The game
+*/
+void startTime(Game * game) {
+    game->elapsedTime = 0;
+}
+
+/**
+ * Make the time of the game go by
+ * 
+ * @param game The game
+ * @param milliseconds Elapsed time since the last call
 */
-void startTime() {
-    startingTime = SDL_GetTicks();
+void advanceTime(Game * game, int milliseconds) {
+    game->elapsedTime += milliseconds;
 }
 
 /**
  * Initialize the spaceship's attributes and launch it
+ * 
+ * @param game The game
 */
-void launchSpaceship() {
-    srand(time(NULL));
+void launchSpaceship(Game * game) {
+    Configuration * configuration = &game->configuration;
 
     double randRadianMin = 0;
     double randRadianMax = 2 * M_PI;
 
-    double radian = randRadianMin + (double) rand() / RAND_MAX * randRadianMax;
+    double radian = randRadianMin + getRandomNumber(&game->randomState) * randRadianMax;
 
-    configuration.spaceship.trajectoryAngle.angle   = radian;
-    configuration.spaceship.instructionsAngle.angle = radian;
-    configuration.spaceship.gravityAngle.angle      = radian;
+    configuration->spaceship.velocity.vecX = SPACESHIP_INITIAL_SPEED * cos(radian);
+    configuration->spaceship.velocity.vecY = SPACESHIP_INITIAL_SPEED * sin(radian);
 }
 
 /**
  * Start the game
+ * 
+ * @param game The game
 */
-void startGame() {
-    configuration.spaceship.position = configuration.startingPoint;
+void startGame(Game * game) {
+    Configuration * configuration = &game->configuration;
+
+    configuration->spaceship.position = configuration->startingPoint;
+
+    configuration->spaceship.gravity = (Vector) {0, 0};
 
-    configuration.spaceship.trajectoryAngle  .strength = SPACESHIP_INITIAL_SPEED;
-    configuration.spaceship.instructionsAngle.strength = 0;
-    configuration.spaceship.gravityAngle     .strength = 0;
+    clearTrail(game->trail);
 
-    configuration.spaceship.minSpeed = configuration.spaceship.trajectoryAngle.strength / 2;
-    configuration.spaceship.maxSpeed = configuration.spaceship.trajectoryAngle.strength * 2;
+    configuration->spaceship.minSpeed = SPACESHIP_INITIAL_SPEED / 2;
+    configuration->spaceship.maxSpeed = SPACESHIP_INITIAL_SPEED * 2;
 
-    launchSpaceship();
+    // Rotation applied to the trajectory at each tick while a direction key is pressed
+    game->steeringCos = cos(M_PI / 60);
+    game->steeringSin = sin(M_PI / 60);
+
+    launchSpaceship(game);
 }
 
 /**
- * Rotate a planet
+ * Get the farthest distance between a planet and its sun
+ * 
+ * @param planet The planet
  * 
+ * @return Distance of the apoapsis (the radius of a circular orbit)
+*/
+Real getOrbitReach(Planet planet) {
+    return abs(planet.orbit) * (1 + planet.eccentricity);
+}
+
+/**
+ * Get the mean anomaly of a planet (its angle on a circular orbit of the same period)
+ * 
+ * @param game Game giving the time
+ * @param planet The planet
+ * 
+ * @return Angle in radians from the periapsis
+*/
+double getMeanAnomaly(Game * game, Planet planet) {
+    return game->elapsedTime % (planet.radius * 1000) * 2 * M_PI / (planet.radius * 1000) + planet.phase;
+}
+
+/**
+ * Rotate a planet on a circular orbit
+ * 
+ * @param game Game giving the time
  * @param sun Sun around which the planet orbits
  * @param planet Planet to rotate
  * 
  * @return New position of the planet
 */
-Position rotatePlanet(Sun sun, Planet planet) {
+Position rotatePlanet(Game * game, Sun sun, Planet planet) {
     // Angle of the planet relative to the sun
-    double radian = (SDL_GetTicks() - startingTime) % (planet.radius * 1000) * 2 * M_PI / (planet.radius * 1000) - 0.5 * M_PI;
+    double radian = getMeanAnomaly(game, planet) + planet.periapsis - 0.5 * M_PI;
 
     // Adaptation of the angle relative to its direction of rotation
     if (planet.orbit < 0) {
@@ -499,117 +1165,271 @@ Position rotatePlanet(Sun sun, Planet planet) {
     return (Position) {sun.position.posX + planet.orbit * cos(radian), sun.position.posY + planet.orbit * sin(radian)};
 }
 
+/**
+ * Solve Kepler's equation (M = E - e sin E) for a batch of orbits, with the same number of Newton iterations for all of them so that the loops have no branch
+ * 
+ * @param nbOrbits Number of orbits (at most KEPLER_BATCH)
+ * @param meanAnomalies Mean anomalies M, between -pi and pi
+ * @param eccentricities Eccentricities e, lower than 1
+ * @param sines Receives the sines of the eccentric anomalies E
+ * @param cosines Receives the cosines of the eccentric anomalies E
+*/
+void solveKeplerBatch(int nbOrbits, Real * meanAnomalies, Real * eccentricities, Real * sines, Real * cosines) {
+    // Local copies of a whole batch, so that the iterations run over a fixed number of orbits that the compiler vectorizes
+    Real batchMeanAnomalies[KEPLER_BATCH] = {0};
+    Real batchEccentricities[KEPLER_BATCH] = {0};
+    Real anomalies[KEPLER_BATCH] = {0};
+    Real batchSines[KEPLER_BATCH] = {0};
+    Real batchCosines[KEPLER_BATCH];
+
+    // Starting guess of Danby, whose sine and cosine are the only trigonometric calls
+    for (int i = 0; i < nbOrbits; i++) {
+        batchMeanAnomalies[i] = meanAnomalies[i];
+        batchEccentricities[i] = eccentricities[i];
+
+        anomalies[i] = meanAnomalies[i] + 0.85 * eccentricities[i] * (meanAnomalies[i] < 0 ? -1 : 1);
+
+        batchSines[i] = sin(anomalies[i]);
+        batchCosines[i] = cos(anomalies[i]);
+    }
+
+    // The unused slots stay on a circle at the periapsis
+    for (int i = nbOrbits; i < KEPLER_BATCH; i++) {
+        batchCosines[i] = 1;
+    }
+
+    for (int iteration = 0; iteration < KEPLER_ITERATIONS; iteration++) {
+        for (int i = 0; i < KEPLER_BATCH; i++) {
+            Real step = (batchMeanAnomalies[i] - anomalies[i] + batchEccentricities[i] * batchSines[i]) / (1 - batchEccentricities[i] * batchCosines[i]);
+
+            // The sine and the cosine are turned by the step, with Taylor series (the steps are small, and multiplying by the inverses avoids divisions)
+            Real step2 = step * step;
+            Real stepSine = step * (1 - step2 * (1 / 6.0) * (1 - step2 * (1 / 20.0) * (1 - step2 * (1 / 42.0) * (1 - step2 * (1 / 72.0)))));
+            Real stepCosine = 1 - step2 * (1 / 2.0) * (1 - step2 * (1 / 12.0) * (1 - step2 * (1 / 30.0) * (1 - step2 * (1 / 56.0) * (1 - step2 * (1 / 90.0)))));
+
+            Real sine = batchSines[i];
+
+            anomalies[i] += step;
+            batchSines[i] = sine * stepCosine + batchCosines[i] * stepSine;
+            batchCosines[i] = batchCosines[i] * stepCosine - sine * stepSine;
+        }
+    }
+
+    for (int i = 0; i < nbOrbits; i++) {
+        sines[i] = batchSines[i];
+        cosines[i] = batchCosines[i];
+    }
+}
+
+/**
+ * Calculate a point of the orbit of a planet from its eccentric anomaly
+ * 
+ * @param sunPosition Position of the sun, at a focus of the orbit
+ * @param planet The planet
+ * @param sine Sine of the eccentric anomaly
+ * @param cosine Cosine of the eccentric anomaly
+ * 
+ * @return Position of the point
+*/
+Position placeOnOrbit(Position sunPosition, Planet planet, Real sine, Real cosine) {
+    Real semiMajorAxis = abs(planet.orbit);
+
+    // Position relative to the sun, the periapsis being on the X axis
+    Real x = semiMajorAxis * (cosine - planet.eccentricity);
+    Real y = semiMajorAxis * REAL_SQRT(1 - planet.eccentricity * planet.eccentricity) * sine;
+
+    // Turning towards the periapsis
+    Real turnedX = x * planet.periapsisX - y * planet.periapsisY;
+    Real turnedY = x * planet.periapsisY + y * planet.periapsisX;
+
+    // Mirrored like the circular orbits turning the other way
+    if (planet.orbit < 0) {
+        turnedX = -turnedX;
+    }
+
+    return (Position) {sunPosition.posX + turnedX, sunPosition.posY + turnedY};
+}
+
+/**
+ * Rotate planets on elliptical orbits
+ * 
+ * @param nbPlanets Number of planets (at most KEPLER_BATCH)
+ * @param planets The planets
+ * @param sunPositions Positions of their suns
+ * @param meanAnomalies Mean anomalies of the planets, between -pi and pi
+ * @param eccentricities Eccentricities of their orbits
+*/
+void rotateEllipticalPlanets(int nbPlanets, Planet ** planets, Position * sunPositions, Real * meanAnomalies, Real * eccentricities) {
+    Real sines[KEPLER_BATCH];
+    Real cosines[KEPLER_BATCH];
+
+    solveKeplerBatch(nbPlanets, meanAnomalies, eccentricities, sines, cosines);
+
+    for (int i = 0; i < nbPlanets; i++) {
+        planets[i]->position = placeOnOrbit(sunPositions[i], *planets[i], sines[i], cosines[i]);
+    }
+}
+
 /**
  * Rotates all the planets
+ * 
+ * @param game The game
 */
-void rotatePlanets() {
+void rotatePlanets(Game * game) {
+    Configuration * configuration = &game->configuration;
+
+    // Elliptical orbits waiting to be solved together
+    int nbEllipticalPlanets = 0;
+    Planet * ellipticalPlanets[KEPLER_BATCH];
+    Position sunPositions[KEPLER_BATCH];
+    Real meanAnomalies[KEPLER_BATCH];
+    Real eccentricities[KEPLER_BATCH];
+
     // Iterate through all the solar systems
-    for (int i = 0; i < configuration.nbSolarSystems; i++) {
-        SolarSystem solarSystem = configuration.solarSystems[i];
+    for (int i = 0; i < configuration->nbSolarSystems; i++) {
+        SolarSystem solarSystem = configuration->solarSystems[i];
 
         // Iterate through all the planets
         for (int j = 0; j < solarSystem.nbPlanets; j++) {
+            Planet * planet = &solarSystem.planets[j];
+
             // Calculation of the new planet's position
-            solarSystem.planets[j].position = rotatePlanet(solarSystem.sun, solarSystem.planets[j]);
+            if (planet->eccentricity == 0) {
+                planet->position = rotatePlanet(game, solarSystem.sun, *planet);
+                continue;
+            }
+
+            // Mean anomaly brought between -pi and pi (the phase is at most one more turn)
+            double meanAnomaly = getMeanAnomaly(game, *planet);
+            if (meanAnomaly > M_PI) meanAnomaly -= 2 * M_PI;
+            if (meanAnomaly > M_PI) meanAnomaly -= 2 * M_PI;
+
+            ellipticalPlanets[nbEllipticalPlanets] = planet;
+            sunPositions[nbEllipticalPlanets] = solarSystem.sun.position;
+            meanAnomalies[nbEllipticalPlanets] = meanAnomaly;
+            eccentricities[nbEllipticalPlanets] = planet->eccentricity;
+
+            if (++nbEllipticalPlanets == KEPLER_BATCH) {
+                rotateEllipticalPlanets(nbEllipticalPlanets, ellipticalPlanets, sunPositions, meanAnomalies, eccentricities);
+                nbEllipticalPlanets = 0;
+            }
         }
     }
+
+    if (nbEllipticalPlanets > 0) {
+        rotateEllipticalPlanets(nbEllipticalPlanets, ellipticalPlanets, sunPositions, meanAnomalies, eccentricities);
+    }
 }
 
 /**
  * Changes the variable managing the left rotation of the spaceship to a true state
+ * 
+ * @param game The game
 */
-void startTurningLeft() {
-    leftKeyPressed = true;
+void startTurningLeft(Game * game) {
+    game->leftKeyPressed = true;
 }
 
 /**
  * Changes the variable managing the right rotation of the spaceship to a true state
+ * 
+ * @param game The game
 */
-void startTurningRight() {
-    rightKeyPressed = true;
+void startTurningRight(Game * game) {
+    game->rightKeyPressed = true;
 }
 
 /**
  * Changes the variable managing the left rotation of the spaceship to a false state
+ * 
+ * @param game The game
 */
-void stopTurningLeft() {
-    leftKeyPressed = false;
+void stopTurningLeft(Game * game) {
+    game->leftKeyPressed = false;
 }
 
 /**
  * Changes the variable managing the right rotation of the spaceship to a false state
+ * 
+ * @param game The game
 */
-void stopTurningRight() {
-    rightKeyPressed = false;
+void stopTurningRight(Game * game) {
+    game->rightKeyPressed = false;
 }
 
 /**
  * Apply the toricity to given coordinates
  * 
+ * @param game Game whose world is used
  * @param position The coordinates to which we want to apply the toricity
  * 
  * @return The new coordinates with toricity applied
 */
-Position applyToricity(Position position) {
-    int width = configuration.winWidth;
-    int height = configuration.winHeight;
+Position applyToricity(Game * game, Position position) {
+    Configuration * configuration = &game->configuration;
+
+    int width = configuration->worldWidth;
+    int height = configuration->worldHeight;
 
     // Managing of the horizontal toricity
-    position.posX = fmod(position.posX + width, width);
+    position.posX = REAL_FMOD(position.posX + width, width);
 
     // Managing of the vertical toricity
-    position.posY = fmod(position.posY + height, height);
+    position.posY = REAL_FMOD(position.posY + height, height);
 
     return position;
 }
 
 /**
- * Calculates a toroidal distance between to positions
+ * Calculates the shortest toroidal displacement between two positions
  * 
+ * @param game Game whose world is used
  * @param p1 First position
  * @param p2 Second position
  * 
- * @return Toroidal distance
+ * @return Vector going from the first position to the second one
 */
-double toroidalDistance(Position p1, Position p2) {
-    int width = configuration.winWidth;
-    int height = configuration.winHeight;
+Vector toroidalDelta(Game * game, Position p1, Position p2) {
+    Configuration * configuration = &game->configuration;
+
+    int width = configuration->worldWidth;
+    int height = configuration->worldHeight;
 
     // Standardization of lengths according to toricity dimensions
-    double dX = fmod(fabs(p1.posX - p2.posX), width);
-    double dY = fmod(fabs(p1.posY - p2.posY), height);
+    Real dX = REAL_FMOD(p2.posX - p1.posX, width);
+    Real dY = REAL_FMOD(p2.posY - p1.posY, height);
 
     // Managing of the horizontal toricity
-    if (dX > width / 2) {
-        dX = width - dX;
-    }
+    if (dX >  width / (Real) 2) dX -= width;
+    if (dX < -width / (Real) 2) dX += width;
 
     // Managing of the vertical toricity
-    if (dY > height / 2) {
-        dY = height - dY;
-    }
+    if (dY >  height / (Real) 2) dY -= height;
+    if (dY < -height / (Real) 2) dY += height;
 
-    return sqrt(pow(dX, 2) + pow(dY, 2));
+    return (Vector) {dX, dY};
 }
 
 /**
- * Calculates a toroidal radian angle between to positions
+ * Calculates the length of a vector
  * 
- * @param p1 First position
- * @param p2 Second position
+ * @param vector The vector
  * 
- * @return Radian angle
+ * @return Length of the vector
 */
-double toroidalRadian(Position p1, Position p2) {
-    int height = configuration.winWidth;
-    int width = configuration.winHeight;
-
-    // Standardization of lengths according to toricity dimensions
-    double dx = fmod(p2.posX - p1.posX + width  / 2.0, width ) - width  / 2.0;
-    double dy = fmod(p2.posY - p1.posY + height / 2.0, height) - height / 2.0;
+Real getVectorStrength(Vector vector) {
+    return REAL_SQRT(vector.vecX * vector.vecX + vector.vecY * vector.vecY);
+}
 
-    // Angle calculation
-    double radian = atan2(dy, dx);
+/**
+ * Calculates the radian angle of a vector
+ * 
+ * @param vector The vector
+ * 
+ * @return Radian angle between 0 and 2*PI
+*/
+double getVectorAngle(Vector vector) {
+    double radian = atan2(vector.vecY, vector.vecX);
 
     // Angle standardization between 0 and 2*PI
     if (radian < 0) {
@@ -620,154 +1440,282 @@ double toroidalRadian(Position p1, Position p2) {
 }
 
 /**
- * Calculate the vectors's angle weighted average
+ * Rotates a vector using the precomputed cosinus and sinus of the rotation angle
  * 
- * @param vectors Vectors used in the average
- * @param distances Distances that weight the average
- * @param nbVectors Number of vectors
+ * @param vector The vector to rotate
+ * @param cosinus Cosinus of the rotation angle
+ * @param sinus Sinus of the rotation angle
  * 
- * @return Angles weighted average
+ * @return Rotated vector
 */
-double calculateWeightedAngleAverage(Vector * vectors, double * distances, int nbVectors) {
-    double totalX = 0.0;
-    double totalY = 0.0;
+Vector rotateVector(Vector vector, Real cosinus, Real sinus) {
+    return (Vector) {
+        vector.vecX * cosinus - vector.vecY * sinus,
+        vector.vecX * sinus   + vector.vecY * cosinus
+    };
+}
 
-    // Iterate through all the vectors
-    for (int i = 0; i < nbVectors; i++) {
-        double strength = vectors[i].strength * distances[i];
-        totalX += strength * cos(vectors[i].angle);
-        totalY += strength * sin(vectors[i].angle);
-    }
+/**
+ * Set the distance beyond which the bodies don't pull the spaceship
+ * 
+ * @param game The game
+ * @param cutoff The distance (0 for no limit)
+*/
+void setGravityCutoff(Game * game, double cutoff) {
+    game->gravityCutoff = cutoff > 0 ? cutoff : 0;
+    game->configuration.spaceship.neighbors.upToDate = false;
 
-    double angle = atan2(totalY, totalX);
+    selectStepVariant(game);
+}
 
-    // Normalization of the average angle between 0 and 2*PI
-    if (angle < 0.0) {
-        angle += 2.0 * M_PI;
-    }
+/**
+ * Compare two body references by solar system then planet (for qsort)
+*/
+int compareBodyReferences(const void * a, const void * b) {
+    BodyReference * body1 = (BodyReference *) a;
+    BodyReference * body2 = (BodyReference *) b;
 
-    return angle;
+    if (body1->solarSystem != body2->solarSystem) return body1->solarSystem - body2->solarSystem;
+
+    return body1->planet - body2->planet;
 }
 
 /**
- * Calculate the vectors's forces weighted average
+ * List the bodies that can get closer to the spaceship than the gravity cutoff, plus the skin
  * 
- * @param vectors Vectors used in the average
- * @param distances Distances that weight the average
- * @param nbVectors Number of vectors
+ * The list stays valid while the spaceship moves less than half of the skin, whatever the planets do on their orbits
  * 
- * @return Forces weighted average
+ * @param game The game
 */
-double calculateWeightedForceAverage(Vector * vectors, double * distances, int nbVectors) {
-    double weightedSum = 0.0;
-    double totalDistance = 0.0;
+void buildNeighborList(Game * game) {
+    Configuration * configuration = &game->configuration;
+    NeighborList * neighbors = &configuration->spaceship.neighbors;
+
+    Position origin = configuration->spaceship.position;
+    double reach = game->gravityCutoff + NEIGHBOR_SKIN;
+
+    neighbors->nbBodies = 0;
+
+    int rangesX[2][2], rangesY[2][2];
+    int nbRangesX = getChunkRanges(origin.posX, reach, configuration->worldWidth,  configuration->nbChunksX, rangesX);
+    int nbRangesY = getChunkRanges(origin.posY, reach, configuration->worldHeight, configuration->nbChunksY, rangesY);
+
+    // Iterate through the chunks around the spaceship
+    for (int ry = 0; ry < nbRangesY; ry++) {
+        for (int y = rangesY[ry][0]; y <= rangesY[ry][1]; y++) {
+            for (int rx = 0; rx < nbRangesX; rx++) {
+                for (int x = rangesX[rx][0]; x <= rangesX[rx][1]; x++) {
+                    Chunk chunk = configuration->chunks[y * configuration->nbChunksX + x];
+
+                    for (int k = 0; k < chunk.nbBodies; k++) {
+                        BodyReference body = chunk.bodies[k];
+                        SolarSystem solarSystem = configuration->solarSystems[body.solarSystem];
+
+                        // A planet can be anywhere on its orbit
+                        Real orbit = body.planet < 0 ? 0 : getOrbitReach(solarSystem.planets[body.planet]);
+
+                        if (getVectorStrength(toroidalDelta(game, origin, solarSystem.sun.position)) - orbit >= reach) continue;
+
+                        if (neighbors->nbBodies == neighbors->capacity) {
+                            neighbors->capacity = neighbors->capacity == 0 ? 16 : 2 * neighbors->capacity;
+                            neighbors->bodies = realloc(neighbors->bodies, neighbors->capacity * sizeof(BodyReference));
+                        }
+
+                        neighbors->bodies[neighbors->nbBodies++] = body;
+                    }
+                }
+            }
+        }
+    }
+
+    // A body covering several chunks is kept once, in the order of the configuration
+    if (neighbors->nbBodies > 1) qsort(neighbors->bodies, neighbors->nbBodies, sizeof(BodyReference), compareBodyReferences);
 
-    // Iterate through all the vectors
-    for (int i = 0; i < nbVectors; i++) {
-        weightedSum += vectors[i].strength * distances[i] * vectors[i].strength;
-        totalDistance += distances[i];
+    int nbUniqueBodies = 0;
+
+    for (int i = 0; i < neighbors->nbBodies; i++) {
+        if (nbUniqueBodies == 0 || compareBodyReferences(&neighbors->bodies[i], &neighbors->bodies[nbUniqueBodies - 1]) != 0) {
+            neighbors->bodies[nbUniqueBodies++] = neighbors->bodies[i];
+        }
     }
 
-    // Weighted average calculation
-    return weightedSum / totalDistance;
+    neighbors->nbBodies = nbUniqueBodies;
+    neighbors->origin = origin;
+    neighbors->upToDate = true;
 }
 
 /**
- * Move the spaceship based on his directionnal vectors
+ * Calculate the factor fading the pull of a body near the gravity cutoff
+ * 
+ * @param cutoff The gravity cutoff (0 for no limit)
+ * @param distance Distance between the spaceship and the body
+ * 
+ * @return 1 before the taper, 0 after the cutoff and a smooth transition between them
 */
-void moveSpaceship() {
-    Spaceship spaceship = configuration.spaceship;
+Real getGravityTaper(Real cutoff, Real distance) {
+    if (cutoff <= 0) return 1;
 
-    Vector vectors[configuration.nbStars];
+    Real taperStart = GRAVITY_TAPER_START * cutoff;
 
-    if (configuration.nbStars == 0) {
-        spaceship.gravityAngle.strength = 0;
-        spaceship.gravityAngle.angle = 0;
-    } else {
-        double starsDistances[configuration.nbStars];
+    if (distance <= taperStart) return 1;
+    if (distance >= cutoff) return 0;
 
-        int index = 0;
+    Real x = (distance - taperStart) / (cutoff - taperStart);
 
-        // Iterate through all the solar systems
-        for (int i = 0; i < configuration.nbSolarSystems; i++) {
-            SolarSystem solarSystem = configuration.solarSystems[i];
+    // Smoothstep, so that neither the pull nor its variation jump
+    return 1 - x * x * (3 - 2 * x);
+}
 
-            Sun sun = solarSystem.sun;
+/**
+ * Sums of the gravity pulls exerted on the spaceship, weighted by the distances
+*/
+typedef struct {
+    Real totalX, totalY;
+    Real weightedForces;
+    Real totalDistance;
+} GravityAccumulator;
+
+// Variants of the spaceship moving, without the computations their worlds don't need
+#define STEP_SUFFIX FreeSpace
+#define STEP_GRAVITY 0
+#define STEP_TOROIDAL 0
+#include "spaceship_step.h"
+
+#define STEP_SUFFIX Gravity
+#define STEP_GRAVITY 1
+#define STEP_TOROIDAL 0
+#include "spaceship_step.h"
+
+#define STEP_SUFFIX ToroidalGravity
+#define STEP_GRAVITY 1
+#define STEP_TOROIDAL 1
+#include "spaceship_step.h"
 
-            starsDistances[index] = toroidalDistance(spaceship.position, sun.position);
+/**
+ * Move the spaceship based on his directionnal vectors, with the variant chosen for the game
+ * 
+ * @param game The game
+*/
+void moveSpaceship(Game * game) {
+    switch (game->stepVariant) {
+        case FREE_SPACE_STEP : {
+            moveSpaceshipFreeSpace(game);
+            break;
+        }
 
-            vectors[index].strength = (G * sun.radius * spaceship.weight) / pow(starsDistances[index], 2);
+        case GRAVITY_STEP : {
+            moveSpaceshipGravity(game);
+            break;
+        }
 
-            vectors[index].angle = toroidalRadian(spaceship.position, sun.position);
+        case TOROIDAL_GRAVITY_STEP : {
+            moveSpaceshipToroidalGravity(game);
+            break;
+        }
+    }
 
-            index++;
+    Trail * trail = game->trail;
 
-            // Iterate through all the planets
-            for (int j = 0; j < solarSystem.nbPlanets; j++) {
-                Planet planet = solarSystem.planets[j];
+    // New position in the trail, in place of the oldest one once it is full
+    if (trail != NULL) {
+        trail->positions[trail->next] = game->configuration.spaceship.position;
+
+        trail->next = trail->next + 1 < trail->capacity ? trail->next + 1 : 0;
+        if (trail->nbPositions < trail->capacity) trail->nbPositions++;
+    }
+}
+
+/**
+ * Forget the positions of a trail (when the spaceship jumps somewhere else)
+ * 
+ * @param trail The trail (NULL for none)
+*/
+void clearTrail(Trail * trail) {
+    if (trail == NULL) return;
 
-                starsDistances[index] = toroidalDistance(spaceship.position, planet.position);
+    trail->nbPositions = 0;
+    trail->next = 0;
+}
 
-                vectors[index].strength = (G * planet.radius * spaceship.weight) / pow(starsDistances[index], 2);
+/**
+ * Calculates the strength of the gravity the spaceship would feel on a row of points (same pulls and average as moveSpaceship(), before the speed limit)
+ * 
+ * @param game The game
+ * @param nbPoints Number of points
+ * @param pointsX Horizontal coordinates of the points, in the world
+ * @param pointY Vertical coordinate of the row, in the world
+ * @param weightedForces Room for the sums of the weighted forces of the points
+ * @param totalDistances Room for the sums of the distances of the points
+ * @param strengths Strengths of the gravity of the points, filled
+*/
+void getGravityStrengths(Game * game, int nbPoints, Real * pointsX, Real pointY, Real * weightedForces, Real * totalDistances, Real * strengths) {
+    Configuration * configuration = &game->configuration;
 
-                vectors[index].angle = toroidalRadian(spaceship.position, planet.position);
+    Real width = configuration->worldWidth;
+    Real weight = configuration->spaceship.weight;
 
-                index++;
-            }
-        }
+    // Without cutoff, the taper stays at 1
+    Real cutoff = (Real) game->gravityCutoff;
+    Real taperStart = GRAVITY_TAPER_START * cutoff;
+    Real taperScale = cutoff > 0 ? 1 / (cutoff - taperStart) : 0;
 
-        // Calculation of the weighted average of the angles's forces and gravities
-        spaceship.gravityAngle.strength = calculateWeightedForceAverage(vectors, starsDistances, configuration.nbStars);
-        spaceship.gravityAngle.angle    = calculateWeightedAngleAverage(vectors, starsDistances, configuration.nbStars);
+    for (int k = 0; k < nbPoints; k++) {
+        weightedForces[k] = 0;
+        totalDistances[k] = 0;
     }
 
-    if (spaceship.gravityAngle.strength > spaceship.maxSpeed) spaceship.gravityAngle.strength = spaceship.maxSpeed;
+    // Iterate through all the bodies (suns first, then planets)
+    for (int i = 0; i < configuration->nbSolarSystems; i++) {
+        SolarSystem solarSystem = configuration->solarSystems[i];
 
-    double angle = atan2(
-        spaceship.trajectoryAngle.strength * sin(spaceship.trajectoryAngle.angle) + spaceship.gravityAngle.strength * sin(spaceship.gravityAngle.angle),
-        spaceship.trajectoryAngle.strength * cos(spaceship.trajectoryAngle.angle) + spaceship.gravityAngle.strength * cos(spaceship.gravityAngle.angle)
-    );
+        for (int j = -1; j < solarSystem.nbPlanets; j++) {
+            Position position = j < 0 ? solarSystem.sun.position : solarSystem.planets[j].position;
+            int radius = j < 0 ? solarSystem.sun.radius : solarSystem.planets[j].radius;
 
-    // Normalization of the angle (between 0 and 2*PI)
-    if (angle < 0.0) {
-        angle += 2.0 * M_PI;
-    }
+            Real dY = toroidalDelta(game, (Position) {0, pointY}, position).vecY;
 
-    spaceship.trajectoryAngle.angle = angle;
+            // Same operations for all the points of the row, without any branch
+            for (int k = 0; k < nbPoints; k++) {
+                Real dX = position.posX - pointsX[k];
 
-    // Considering of the users inputs regarding direction
-    if (leftKeyPressed ) spaceship.trajectoryAngle.angle -= M_PI / 60;
-    if (rightKeyPressed) spaceship.trajectoryAngle.angle += M_PI / 60;
+                dX += (dX < -width / 2) * width - (dX > width / 2) * width;
 
-    configuration.score += leftKeyPressed || rightKeyPressed;
+                // A point at the center of a body is pulled as if it was one pixel away
+                Real squaredDistance = dX * dX + dY * dY;
+                squaredDistance = squaredDistance < 1 ? 1 : squaredDistance;
 
-    double speed = spaceship.trajectoryAngle.strength;
+                Real distance = REAL_SQRT(squaredDistance);
 
-    // Checking speed compliance
-    if (speed < spaceship.minSpeed) speed = spaceship.minSpeed;
-    if (speed > spaceship.maxSpeed) speed = spaceship.maxSpeed;
+                Real x = (distance - taperStart) * taperScale;
+                x = x < 0 ? 0 : x > 1 ? 1 : x;
 
-    // New value of the trajectory angle's force
-    spaceship.trajectoryAngle.strength = speed;
+                Real taper = 1 - x * x * (3 - 2 * x);
 
-    // Calculation of the new position of the spaceship
-    spaceship.position.posX = spaceship.position.posX + spaceship.trajectoryAngle.strength * cos(spaceship.trajectoryAngle.angle);
-    spaceship.position.posY = spaceship.position.posY + spaceship.trajectoryAngle.strength * sin(spaceship.trajectoryAngle.angle);
+                Real strength = taper * (G * radius * weight) / squaredDistance;
 
-    configuration.spaceship = spaceship;
+                weightedForces[k] += strength * distance * strength;
+                totalDistances[k] += taper * distance;
+            }
+        }
+    }
 
-    // Toricity applying
-    configuration.spaceship.position = applyToricity(configuration.spaceship.position);
+    for (int k = 0; k < nbPoints; k++) {
+        strengths[k] = totalDistances[k] > 0 ? weightedForces[k] / totalDistances[k] : 0;
+    }
 }
 
 /**
  * Determine if the game is win
  * 
+ * @param game The game
+ * 
  * @return True if the game is lost, false else
 */
-bool isGameWin() {
-    Position spaceshipPosition = configuration.spaceship.position;
-    Position arrivalPointPosition = configuration.arrivalPoint;
+bool isGameWin(Game * game) {
+    Configuration * configuration = &game->configuration;
+
+    Position spaceshipPosition = configuration->spaceship.position;
+    Position arrivalPointPosition = configuration->arrivalPoint;
 
     return abs(spaceshipPosition.posX - arrivalPointPosition.posX) < 5 && abs(spaceshipPosition.posY - arrivalPointPosition.posY) < 5;
 }
@@ -775,14 +1723,18 @@ bool isGameWin() {
 /**
  * Determine if the game is lost
  * 
+ * @param game The game
+ * 
  * @return True if the game is lost, false else
 */
-bool isGameLost() {
-    Position spaceshipPosition = configuration.spaceship.position;
+bool isGameLost(Game * game) {
+    Configuration * configuration = &game->configuration;
+
+    Position spaceshipPosition = configuration->spaceship.position;
 
     // Iterate through all the solar systems
-    for (int i = 0; i < configuration.nbSolarSystems; i++) {
-        SolarSystem solarSystem = configuration.solarSystems[i];
+    for (int i = 0; i < configuration->nbSolarSystems; i++) {
+        SolarSystem solarSystem = configuration->solarSystems[i];
 
         Sun sun = solarSystem.sun;
 
@@ -807,19 +1759,31 @@ bool isGameLost() {
 
 /**
  * Frees dynamically allocated memories
+ * 
+ * @param game The game
 */
-void freeAllocations() {
-    // Iterate through all the solar systems
-    for (int i = 0; i < configuration.nbSolarSystems; i++) {
-        free(configuration.solarSystems[i].planets);
-    }
+void freeAllocations(Game * game) {
+    Configuration * configuration = &game->configuration;
+
+    // Solar systems and planets, all at once
+    freeArena(&configuration->bodiesArena);
+
+    configuration->solarSystems = NULL;
+    configuration->nbSolarSystems = 0;
 
-    free(configuration.solarSystems);
+    freeChunks(configuration);
+
+    free(configuration->spaceship.neighbors.bodies);
+
+    NeighborList emptyNeighborList = {0};
+    configuration->spaceship.neighbors = emptyNeighborList;
 }
 
 /**
  * Game's configuration accessor
+ * 
+ * @param game The game
 */
-Configuration getConfiguration() {
-    return configuration;
+Configuration getConfiguration(Game * game) {
+    return game->configuration;
 }
@@ -5,8 +5,19 @@
 /* Structures */
 /* ---------- */
 
+// Precision of the physics (positions, vectors and distances), chosen at build time
+#ifdef SINGLE_PRECISION_PHYSICS
+typedef float Real;
+#define REAL_SQRT sqrtf
+#define REAL_FMOD fmodf
+#else
+typedef double Real;
+#define REAL_SQRT sqrt
+#define REAL_FMOD fmod
+#endif
+
 typedef struct {
-    double posX, posY;
+    Real posX, posY;
 } Position;
 
 typedef struct {
@@ -14,6 +25,16 @@ typedef struct {
 
     int radius;
     int orbit;
+
+    // Shape of the orbit (0 for a circle, the sun being at a focus of the ellipse otherwise)
+    Real eccentricity;
+
+    // Angles in radians of the periapsis and of the planet at the start, in its direction of rotation
+    Real periapsis;
+    Real phase;
+
+    // Direction of the periapsis, computed once from its angle
+    Real periapsisX, periapsisY;
 } Planet;
 
 typedef struct {
@@ -29,24 +50,56 @@ typedef struct {
 } SolarSystem;
 
 typedef struct {
-    double strength;
-    double angle;
+    Real vecX, vecY;
 } Vector;
 
+typedef struct {
+    // Body of a solar system (planet index or -1 for the sun)
+    int solarSystem;
+    int planet;
+
+    // First chunk covered by the body
+    int firstChunkX, firstChunkY;
+} BodyReference;
+
+typedef struct {
+    // Bodies that can pull the spaceship while it stays near the position the list was built at
+    int nbBodies;
+    int capacity;
+    BodyReference * bodies;
+
+    Position origin;
+    bool upToDate;
+} NeighborList;
+
 typedef struct {
     Position position;
 
-    Vector trajectoryAngle;
-    Vector instructionsAngle;
-    Vector gravityAngle;
+    Vector velocity;
+    Vector gravity;
     int weight;
 
     int minSpeed;
     int maxSpeed;
+
+    NeighborList neighbors;
 } Spaceship;
 
+typedef struct {
+    int nbBodies;
+    BodyReference * bodies;
+} Chunk;
+
+typedef struct {
+    // Single block of memory sliced by the allocations (freed all at once)
+    size_t size;
+    size_t used;
+    unsigned char * memory;
+} Arena;
+
 typedef struct {
     int winWidth, winHeight;
+    int worldWidth, worldHeight;
 
     Position startingPoint;
     Position arrivalPoint;
@@ -56,32 +109,109 @@ typedef struct {
     int nbSolarSystems;
     SolarSystem * solarSystems;
 
+    // Memory of the solar systems and their planets
+    Arena bodiesArena;
+
+    // Square regions of the world listing the bodies that can be drawn in them
+    int nbChunksX, nbChunksY;
+    Chunk * chunks;
+
+    // Memory of the chunks and their lists
+    Arena chunksArena;
+
     int score;
 } Configuration;
 
+typedef struct {
+    // Last positions of the spaceship, the oldest being overwritten (allocated once by its owner)
+    int capacity;
+    int nbPositions;
+    int next;
+    Position * positions;
+} Trail;
+
+// Variants of the spaceship moving (the general one first, so that a zeroed game uses it)
+typedef enum {
+    TOROIDAL_GRAVITY_STEP,
+    GRAVITY_STEP,
+    FREE_SPACE_STEP
+} StepVariant;
+
+typedef struct {
+    Configuration configuration;
+
+    // Simulated time since the start of the game (in milliseconds)
+    unsigned int elapsedTime;
+
+    bool leftKeyPressed;
+    bool rightKeyPressed;
+
+    Real steeringCos;
+    Real steeringSin;
+
+    unsigned int randomState;
+
+    // Distance beyond which the bodies don't pull the spaceship (0 for no limit)
+    double gravityCutoff;
+
+    // Variant of the spaceship moving fitting the bodies and the cutoff
+    StepVariant stepVariant;
+
+    // Positions written by moveSpaceship() at each tick (NULL to keep none)
+    Trail * trail;
+} Game;
+
+/* --------- */
+/* Constants */
+/* --------- */
+
+// Duration of a simulation step (in milliseconds)
+#define TICK_DURATION (1000 / 60)
+
+// Side of the world's chunks
+#define CHUNK_SIZE 256
+
 /* --------- */
 /* Functions */
 /* --------- */
 
-void loadConfigFile();
+bool loadConfigFile(Game * game, char * path);
+bool allocateSolarSystems(Configuration * configuration, int nbSolarSystems, int nbPlanets);
+Planet * allocatePlanets(Configuration * configuration, int nbPlanets);
+int updateConfiguration(Game * game, Configuration * newConfiguration);
+void buildChunks(Game * game);
+
+unsigned int mixSeed(unsigned int seed);
+void setSeed(Game * game, unsigned int seed);
+double getRandomNumber(unsigned int * state);
+
+void startTime(Game * game);
+void advanceTime(Game * game, int milliseconds);
+void startGame(Game * game);
 
-void startTime();
-void startGame();
+Real getOrbitReach(Planet planet);
+Position placeOnOrbit(Position sunPosition, Planet planet, Real sine, Real cosine);
+void rotatePlanets(Game * game);
 
-void rotatePlanets();
+void setGravityCutoff(Game * game, double cutoff);
+void moveSpaceship(Game * game);
+void clearTrail(Trail * trail);
+void getGravityStrengths(Game * game, int nbPoints, Real * pointsX, Real pointY, Real * weightedForces, Real * totalDistances, Real * strengths);
 
-void moveSpaceship();
+void startTurningLeft(Game * game);
+void startTurningRight(Game * game);
+void stopTurningLeft(Game * game);
+void stopTurningRight(Game * game);
 
-void startTurningLeft();
-void startTurningRight();
-void stopTurningLeft();
-void stopTurningRight();
+Vector toroidalDelta(Game * game, Position p1, Position p2);
+Real getVectorStrength(Vector vector);
+double getVectorAngle(Vector vector);
 
-bool isGameWin();
-bool isGameLost();
+bool isGameWin(Game * game);
+bool isGameLost(Game * game);
 
-void freeAllocations();
+void freeAllocations(Game * game);
 
-Configuration getConfiguration();
+Configuration getConfiguration(Game * game);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+/*
+ * Template of the spaceship moving, included by model.c once per variant with :
+ *  - STEP_SUFFIX : suffix of the generated functions
+ *  - STEP_GRAVITY : 1 if some bodies pull the spaceship, 0 otherwise
+ *  - STEP_TOROIDAL : 1 if the pulls can come across the edges of the world, 0 otherwise
+*/
+
+#define STEP_CONCATENATE(name, suffix) name##suffix
+#define STEP_FUNCTION(name, suffix) STEP_CONCATENATE(name, suffix)
+
+#if STEP_GRAVITY
+
+/**
+ * Adds the gravity pull of a spacial object to the accumulator
+ * 
+ * @param game Game whose world is used
+ * @param accumulator Sums of the gravity pulls
+ * @param spaceship Spaceship subject to the gravity
+ * @param position Position of the spacial object
+ * @param radius Radius of the spacial object
+*/
+void STEP_FUNCTION(accumulateGravity, STEP_SUFFIX)(Game * game, GravityAccumulator * accumulator, Spaceship spaceship, Position position, int radius) {
+#if STEP_TOROIDAL
+    Vector delta = toroidalDelta(game, spaceship.position, position);
+#else
+    // The pulls coming from the other side of the edges are beyond the cutoff anyway
+    Vector delta = {position.posX - spaceship.position.posX, position.posY - spaceship.position.posY};
+#endif
+
+    Real squaredDistance = delta.vecX * delta.vecX + delta.vecY * delta.vecY;
+    Real distance = REAL_SQRT(squaredDistance);
+
+    Real taper = getGravityTaper((Real) game->gravityCutoff, distance);
+
+    if (taper == 0) return;
+
+    Real strength = taper * (G * radius * spaceship.weight) / squaredDistance;
+
+    // Strength weighted by the distance, along the unit vector pointing to the object
+    accumulator->totalX += strength * delta.vecX;
+    accumulator->totalY += strength * delta.vecY;
+
+    // A fading body also fades out of the average
+    accumulator->weightedForces += strength * distance * strength;
+    accumulator->totalDistance  += taper * distance;
+}
+
+#endif
+
+/**
+ * Move the spaceship based on his directionnal vectors
+ * 
+ * @param game The game
+*/
+void STEP_FUNCTION(moveSpaceship, STEP_SUFFIX)(Game * game) {
+    Configuration * configuration = &game->configuration;
+
+#if STEP_GRAVITY
+    // Neighbors listing again when the spaceship went too far from where they were listed
+    if (game->gravityCutoff > 0) {
+        NeighborList neighbors = configuration->spaceship.neighbors;
+
+        if (!neighbors.upToDate || getVectorStrength(toroidalDelta(game, neighbors.origin, configuration->spaceship.position)) > NEIGHBOR_SKIN / (Real) 2) {
+            buildNeighborList(game);
+        }
+    }
+#endif
+
+    Spaceship spaceship = configuration->spaceship;
+
+    spaceship.gravity = (Vector) {0, 0};
+
+#if STEP_GRAVITY
+    GravityAccumulator accumulator = {0};
+
+    // Without toricity, there is always a cutoff
+    if (!STEP_TOROIDAL || game->gravityCutoff > 0) {
+        // Iterate through the neighbors only
+        for (int k = 0; k < spaceship.neighbors.nbBodies; k++) {
+            BodyReference body = spaceship.neighbors.bodies[k];
+            SolarSystem solarSystem = configuration->solarSystems[body.solarSystem];
+
+            if (body.planet < 0) {
+                STEP_FUNCTION(accumulateGravity, STEP_SUFFIX)(game, &accumulator, spaceship, solarSystem.sun.position, solarSystem.sun.radius);
+            } else {
+                STEP_FUNCTION(accumulateGravity, STEP_SUFFIX)(game, &accumulator, spaceship, solarSystem.planets[body.planet].position, solarSystem.planets[body.planet].radius);
+            }
+        }
+    } else {
+        // Iterate through all the solar systems
+        for (int i = 0; i < configuration->nbSolarSystems; i++) {
+            SolarSystem solarSystem = configuration->solarSystems[i];
+
+            STEP_FUNCTION(accumulateGravity, STEP_SUFFIX)(game, &accumulator, spaceship, solarSystem.sun.position, solarSystem.sun.radius);
+
+            // Iterate through all the planets
+            for (int j = 0; j < solarSystem.nbPlanets; j++) {
+                STEP_FUNCTION(accumulateGravity, STEP_SUFFIX)(game, &accumulator, spaceship, solarSystem.planets[j].position, solarSystem.planets[j].radius);
+            }
+        }
+    }
+
+    // No pull at all when every body is too far
+    if (accumulator.totalDistance > 0) {
+        // Weighted average of the forces
+        Real force = accumulator.weightedForces / accumulator.totalDistance;
+
+        if (force > spaceship.maxSpeed) force = spaceship.maxSpeed;
+
+        // Direction of the weighted sum of the pulls
+        Real norm = REAL_SQRT(accumulator.totalX * accumulator.totalX + accumulator.totalY * accumulator.totalY);
+
+        if (norm > 0) {
+            spaceship.gravity = (Vector) {force * accumulator.totalX / norm, force * accumulator.totalY / norm};
+        } else {
+            spaceship.gravity = (Vector) {force, 0};
+        }
+    }
+#endif
+
+    // Direction of the trajectory deviated by the gravity
+    Vector direction = {spaceship.velocity.vecX + spaceship.gravity.vecX, spaceship.velocity.vecY + spaceship.gravity.vecY};
+
+    Real norm = getVectorStrength(direction);
+
+    if (norm > 0) {
+        direction = (Vector) {direction.vecX / norm, direction.vecY / norm};
+    } else {
+        direction = (Vector) {1, 0};
+    }
+
+    // Considering of the users inputs regarding direction
+    if (game->leftKeyPressed ) direction = rotateVector(direction, game->steeringCos, -game->steeringSin);
+    if (game->rightKeyPressed) direction = rotateVector(direction, game->steeringCos,  game->steeringSin);
+
+    configuration->score += game->leftKeyPressed || game->rightKeyPressed;
+
+    Real speed = getVectorStrength(spaceship.velocity);
+
+    // Checking speed compliance
+    if (speed < spaceship.minSpeed) speed = spaceship.minSpeed;
+    if (speed > spaceship.maxSpeed) speed = spaceship.maxSpeed;
+
+    // New velocity of the spaceship
+    spaceship.velocity = (Vector) {direction.vecX * speed, direction.vecY * speed};
+
+    // Calculation of the new position of the spaceship
+    spaceship.position.posX = spaceship.position.posX + spaceship.velocity.vecX;
+    spaceship.position.posY = spaceship.position.posY + spaceship.velocity.vecY;
+
+    configuration->spaceship = spaceship;
+
+    // Toricity applying
+    configuration->spaceship.position = applyToricity(game, configuration->spaceship.position);
+}
+
+#undef STEP_SUFFIX
+#undef STEP_GRAVITY
+#undef STEP_TOROIDAL
\ No newline at end of file
@@ -0,0 +1,468 @@
+#include <stdbool.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "../model/model.h"
+#include "../worker_pool/worker_pool.h"
+#include "nbody.h"
+
+// Gravitational constant of the mutual pulls, the masses being the radiuses
+#define NBODY_G 10.0
+
+// Smoothing length keeping the pulls finite when two bodies cross each other
+#define NBODY_SOFTENING 8.0
+
+// Number of bodies of a block (both blocks of a pair fit in the L1 cache)
+#define NBODY_BLOCK 128
+
+#define BENCHMARK_WORLD_SIZE 4096
+#define BENCHMARK_STEPS 20
+#define BENCHMARK_MAX_BODIES 8192
+
+typedef struct {
+    int firstBlock;
+    int secondBlock;
+} BlockPair;
+
+// Bodies in structure of arrays (suns and planets in the order of the configuration, then the spaceship)
+static int nbBodies;
+static int bodiesCapacity;
+static Real * bodyX;
+static Real * bodyY;
+static Real * velocityX;
+static Real * velocityY;
+static Real * bodyMass;
+static Real * accelerationX;
+static Real * accelerationY;
+
+static Real worldWidth, worldHeight;
+
+// Pairs of blocks sharing the pairwise pulls, each of them computed by a single thread
+static int nbBlockPairs;
+static BlockPair * blockPairs;
+static SDL_atomic_t nextBlockPair;
+
+// Accelerations summed separately by each thread (the main thread being the first one)
+static int nbAccumulators;
+static Real * threadAccelerationX;
+static Real * threadAccelerationY;
+
+static WorkerPool * nBodyPool;
+
+static int nbSteps;
+static double totalStepTime, minStepTime, maxStepTime;
+
+/**
+ * Add the mutual pulls of two blocks of bodies to the accumulators of a thread
+ * 
+ * @param pair The blocks
+ * @param totalX Horizontal accelerations of the thread
+ * @param totalY Vertical accelerations of the thread
+*/
+void accumulateBlockPair(BlockPair pair, Real * totalX, Real * totalY) {
+    int firstStart = pair.firstBlock * NBODY_BLOCK;
+    int firstEnd   = firstStart + NBODY_BLOCK < nbBodies ? firstStart + NBODY_BLOCK : nbBodies;
+
+    int secondStart = pair.secondBlock * NBODY_BLOCK;
+    int secondEnd   = secondStart + NBODY_BLOCK < nbBodies ? secondStart + NBODY_BLOCK : nbBodies;
+
+    Real halfWidth  = worldWidth  / 2;
+    Real halfHeight = worldHeight / 2;
+
+    for (int i = firstStart; i < firstEnd; i++) {
+        Real sumX = 0;
+        Real sumY = 0;
+
+        // Each pair of bodies is computed once (from the body of the first block)
+        int start = pair.firstBlock == pair.secondBlock ? i + 1 : secondStart;
+
+        // Branchless inner loop, so that the compiler can vectorize it
+        for (int j = start; j < secondEnd; j++) {
+            Real dX = bodyX[j] - bodyX[i];
+            Real dY = bodyY[j] - bodyY[i];
+
+            // Nearest image of the body on the torus
+            dX += (dX < -halfWidth ) * worldWidth  - (dX > halfWidth ) * worldWidth;
+            dY += (dY < -halfHeight) * worldHeight - (dY > halfHeight) * worldHeight;
+
+            Real squaredDistance = dX * dX + dY * dY + NBODY_SOFTENING * NBODY_SOFTENING;
+            Real factor = NBODY_G / (squaredDistance * sqrt(squaredDistance));
+
+            sumX += factor * bodyMass[j] * dX;
+            sumY += factor * bodyMass[j] * dY;
+
+            // Opposite pull on the other body
+            totalX[j] -= factor * bodyMass[i] * dX;
+            totalY[j] -= factor * bodyMass[i] * dY;
+        }
+
+        totalX[i] += sumX;
+        totalY[i] += sumY;
+    }
+}
+
+/**
+ * Compute pairs of blocks until there is none left
+ * 
+ * @param thread Number of the thread, which is the index of its accumulators
+ * @param data Unused
+*/
+void accumulateRemainingBlockPairs(int thread, void * data) {
+    Real * totalX = threadAccelerationX + thread * bodiesCapacity;
+    Real * totalY = threadAccelerationY + thread * bodiesCapacity;
+
+    memset(totalX, 0, nbBodies * sizeof(Real));
+    memset(totalY, 0, nbBodies * sizeof(Real));
+
+    int index;
+
+    while ((index = SDL_AtomicAdd(&nextBlockPair, 1)) < nbBlockPairs) {
+        accumulateBlockPair(blockPairs[index], totalX, totalY);
+    }
+}
+
+/**
+ * Compute the accelerations of all the bodies in parallel
+*/
+void computeAccelerations() {
+    SDL_AtomicSet(&nextBlockPair, 0);
+
+    // A single block is not worth waking up the workers
+    int nbThreads = runWorkerPool(nBodyPool, nbBlockPairs > 1 ? nbAccumulators : 1, accumulateRemainingBlockPairs, NULL);
+
+    // Sum of the accumulators of the threads that took part
+    memcpy(accelerationX, threadAccelerationX, nbBodies * sizeof(Real));
+    memcpy(accelerationY, threadAccelerationY, nbBodies * sizeof(Real));
+
+    for (int k = 1; k < nbThreads; k++) {
+        Real * totalX = threadAccelerationX + k * bodiesCapacity;
+        Real * totalY = threadAccelerationY + k * bodiesCapacity;
+
+        for (int i = 0; i < nbBodies; i++) {
+            accelerationX[i] += totalX[i];
+            accelerationY[i] += totalY[i];
+        }
+    }
+}
+
+/**
+ * Make room for some bodies and list the pairs of blocks
+ * 
+ * @param count Number of bodies
+*/
+void allocateBodies(int count) {
+    if (count > bodiesCapacity) {
+        bodiesCapacity = count;
+
+        Real ** arrays[] = {&bodyX, &bodyY, &velocityX, &velocityY, &bodyMass, &accelerationX, &accelerationY};
+
+        for (int i = 0; i < (int) (sizeof(arrays) / sizeof(arrays[0])); i++) {
+            free(*arrays[i]);
+            *arrays[i] = malloc(bodiesCapacity * sizeof(Real));
+        }
+
+        free(threadAccelerationX);
+        free(threadAccelerationY);
+
+        threadAccelerationX = malloc(nbAccumulators * bodiesCapacity * sizeof(Real));
+        threadAccelerationY = malloc(nbAccumulators * bodiesCapacity * sizeof(Real));
+    }
+
+    nbBodies = count;
+
+    int nbBlocks = (nbBodies + NBODY_BLOCK - 1) / NBODY_BLOCK;
+
+    free(blockPairs);
+    blockPairs = malloc(nbBlocks * (nbBlocks + 1) / 2 * sizeof(BlockPair));
+
+    nbBlockPairs = 0;
+
+    for (int i = 0; i < nbBlocks; i++) {
+        for (int j = i; j < nbBlocks; j++) {
+            blockPairs[nbBlockPairs++] = (BlockPair) {i, j};
+        }
+    }
+}
+
+/**
+ * Start the workers computing the pulls
+*/
+void startNBodyWorkers() {
+    nBodyPool = createWorkerPool("n-body");
+    nbAccumulators = getWorkerPoolSize(nBodyPool);
+
+    nbSteps = 0;
+    totalStepTime = 0;
+}
+
+/**
+ * Stop the workers and free the bodies
+*/
+void freeNBody() {
+    freeWorkerPool(nBodyPool);
+
+    Real * arrays[] = {bodyX, bodyY, velocityX, velocityY, bodyMass, accelerationX, accelerationY, threadAccelerationX, threadAccelerationY};
+
+    for (int i = 0; i < (int) (sizeof(arrays) / sizeof(arrays[0])); i++) {
+        free(arrays[i]);
+    }
+
+    free(blockPairs);
+
+    bodyX = bodyY = velocityX = velocityY = bodyMass = accelerationX = accelerationY = NULL;
+    threadAccelerationX = threadAccelerationY = NULL;
+    blockPairs = NULL;
+
+    nbBodies = bodiesCapacity = 0;
+}
+
+/**
+ * Copy the bodies of the game in the N-body mode, each planet starting on a circular orbit around its sun
+ * 
+ * @param game The game
+*/
+void loadNBodies(Game * game) {
+    Configuration * configuration = &game->configuration;
+
+    worldWidth  = configuration->worldWidth;
+    worldHeight = configuration->worldHeight;
+
+    // The spaceship pulls the bodies too
+    allocateBodies(configuration->nbStars + 1);
+
+    int index = 0;
+
+    // Iterate through all the solar systems
+    for (int i = 0; i < configuration->nbSolarSystems; i++) {
+        SolarSystem solarSystem = configuration->solarSystems[i];
+
+        int sunIndex = index++;
+
+        bodyX[sunIndex] = solarSystem.sun.position.posX;
+        bodyY[sunIndex] = solarSystem.sun.position.posY;
+        bodyMass[sunIndex] = abs(solarSystem.sun.radius);
+        velocityX[sunIndex] = 0;
+        velocityY[sunIndex] = 0;
+
+        // Iterate through all the planets
+        for (int j = 0; j < solarSystem.nbPlanets; j++) {
+            Planet planet = solarSystem.planets[j];
+
+            bodyX[index] = planet.position.posX;
+            bodyY[index] = planet.position.posY;
+            bodyMass[index] = abs(planet.radius);
+
+            // Speed of a circular orbit around the sun, in the direction of the kinematic rotation
+            Real dX = planet.position.posX - solarSystem.sun.position.posX;
+            Real dY = planet.position.posY - solarSystem.sun.position.posY;
+            Real distance = sqrt(dX * dX + dY * dY);
+
+            Real speed = distance > 0 ? sqrt(NBODY_G * (bodyMass[sunIndex] + bodyMass[index]) / distance) : 0;
+
+            if (planet.orbit < 0) speed = -speed;
+
+            velocityX[index] = distance > 0 ? -speed * dY / distance : 0;
+            velocityY[index] = distance > 0 ?  speed * dX / distance : 0;
+
+            // The sun moves back so that the solar system keeps still
+            velocityX[sunIndex] -= velocityX[index] * bodyMass[index] / bodyMass[sunIndex];
+            velocityY[sunIndex] -= velocityY[index] * bodyMass[index] / bodyMass[sunIndex];
+
+            index++;
+        }
+    }
+
+    // The spaceship only pulls: its own moves are computed by moveSpaceship()
+    bodyX[index] = configuration->spaceship.position.posX;
+    bodyY[index] = configuration->spaceship.position.posY;
+    bodyMass[index] = configuration->spaceship.weight;
+    velocityX[index] = 0;
+    velocityY[index] = 0;
+
+    computeAccelerations();
+}
+
+/**
+ * Enable the N-body mode: suns, planets and spaceship pulling each other
+ * 
+ * @param game The game
+ * 
+ * @return True if the mode is enabled, false otherwise
+*/
+bool startNBody(Game * game) {
+    Configuration configuration = getConfiguration(game);
+
+    // The bodies are found through chunks built from the orbits
+    if (configuration.worldWidth > configuration.winWidth || configuration.worldHeight > configuration.winHeight) {
+        printf("The N-body mode needs a world the size of the window\n");
+        return false;
+    }
+
+    // The neighbors of the spaceship are listed from the orbits too
+    if (game->gravityCutoff > 0) {
+        printf("The gravity cutoff is ignored in the N-body mode\n");
+        setGravityCutoff(game, 0);
+    }
+
+    startNBodyWorkers();
+    loadNBodies(game);
+
+    return true;
+}
+
+/**
+ * Integrate the positions of the bodies over one tick (leapfrog, kick-drift-kick)
+*/
+void integrateBodies() {
+    // The spaceship is left out
+    int nbMovingBodies = nbBodies - 1;
+
+    for (int i = 0; i < nbMovingBodies; i++) {
+        velocityX[i] += 0.5 * accelerationX[i];
+        velocityY[i] += 0.5 * accelerationY[i];
+
+        bodyX[i] += velocityX[i];
+        bodyY[i] += velocityY[i];
+
+        // Toricity applying
+        bodyX[i] -= floor(bodyX[i] / worldWidth ) * worldWidth;
+        bodyY[i] -= floor(bodyY[i] / worldHeight) * worldHeight;
+    }
+
+    computeAccelerations();
+
+    for (int i = 0; i < nbMovingBodies; i++) {
+        velocityX[i] += 0.5 * accelerationX[i];
+        velocityY[i] += 0.5 * accelerationY[i];
+    }
+}
+
+/**
+ * Record the duration of a step
+ * 
+ * @param start Performance counter at the beginning of the step
+*/
+void recordStepTime(Uint64 start) {
+    double duration = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+
+    if (nbSteps == 0 || duration < minStepTime) minStepTime = duration;
+    if (nbSteps == 0 || duration > maxStepTime) maxStepTime = duration;
+
+    totalStepTime += duration;
+    nbSteps++;
+}
+
+/**
+ * Move the suns and the planets under their mutual pulls (replaces rotatePlanets())
+ * 
+ * @param game The game
+*/
+void stepNBody(Game * game) {
+    Configuration * configuration = &game->configuration;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    bodyX[nbBodies - 1] = configuration->spaceship.position.posX;
+    bodyY[nbBodies - 1] = configuration->spaceship.position.posY;
+
+    integrateBodies();
+
+    int index = 0;
+
+    // Iterate through all the solar systems
+    for (int i = 0; i < configuration->nbSolarSystems; i++) {
+        SolarSystem * solarSystem = &configuration->solarSystems[i];
+
+        solarSystem->sun.position = (Position) {bodyX[index], bodyY[index]};
+        index++;
+
+        // Iterate through all the planets
+        for (int j = 0; j < solarSystem->nbPlanets; j++) {
+            solarSystem->planets[j].position = (Position) {bodyX[index], bodyY[index]};
+            index++;
+        }
+    }
+
+    recordStepTime(start);
+}
+
+/**
+ * Print the durations of the steps and disable the N-body mode
+*/
+void stopNBody() {
+    if (nbSteps > 0) {
+        printf("N-body : %d bodies, %d steps, %.3f ms per step (min %.3f, max %.3f)\n", nbBodies, nbSteps, totalStepTime / nbSteps, minStepTime, maxStepTime);
+    }
+
+    freeNBody();
+}
+
+/**
+ * Time the N-body steps of random bodies, from a few hundreds to several thousands
+ * 
+ * @param argc Number of options
+ * @param argv Options
+ * 
+ * @return Exit code of the program
+*/
+int runNBodyBenchmark(int argc, char * argv[]) {
+    int nbBenchmarkSteps = BENCHMARK_STEPS;
+    int maxBodies = BENCHMARK_MAX_BODIES;
+
+    // Command line options reading
+    for (int i = 0; i < argc; i++) {
+        if (!strcmp(argv[i], "--steps") && i + 1 < argc) {
+            nbBenchmarkSteps = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--max-bodies") && i + 1 < argc) {
+            maxBodies = atoi(argv[++i]);
+        } else {
+            printf("Unknown option (%s)\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (nbBenchmarkSteps < 1) nbBenchmarkSteps = 1;
+
+    startNBodyWorkers();
+
+    worldWidth  = BENCHMARK_WORLD_SIZE;
+    worldHeight = BENCHMARK_WORLD_SIZE;
+
+    unsigned randomState = 1;
+
+    printf("%d threads\n", nbAccumulators);
+    printf("%8s | %12s | %12s | %12s | %14s\n", "bodies", "ms per step", "min", "max", "pairs per sec");
+
+    for (int count = 256; count <= maxBodies; count *= 2) {
+        allocateBodies(count);
+
+        // Same bodies from a run to another
+        for (int i = 0; i < count; i++) {
+            bodyX[i] = getRandomNumber(&randomState) * worldWidth;
+            bodyY[i] = getRandomNumber(&randomState) * worldHeight;
+            bodyMass[i] = 5 + getRandomNumber(&randomState) * 15;
+            velocityX[i] = getRandomNumber(&randomState) - 0.5;
+            velocityY[i] = getRandomNumber(&randomState) - 0.5;
+        }
+
+        computeAccelerations();
+
+        nbSteps = 0;
+        totalStepTime = 0;
+
+        for (int step = 0; step < nbBenchmarkSteps; step++) {
+            Uint64 start = SDL_GetPerformanceCounter();
+            integrateBodies();
+            recordStepTime(start);
+        }
+
+        double stepTime = totalStepTime / nbSteps;
+        double nbPairs = (double) count * (count - 1) / 2;
+
+        printf("%8d | %12.3f | %12.3f | %12.3f | %14.0f\n", count, stepTime, minStepTime, maxStepTime, nbPairs / stepTime * 1000);
+    }
+
+    freeNBody();
+
+    return 0;
+}
@@ -0,0 +1,10 @@
+#ifndef NBODY_H
+#define NBODY_H
+
+bool startNBody(Game * game);
+void loadNBodies(Game * game);
+void stepNBody(Game * game);
+void stopNBody();
+int runNBodyBenchmark(int argc, char * argv[]);
+
+#endif
\ No newline at end of file
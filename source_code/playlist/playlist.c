@@ -0,0 +1,116 @@
+#include <stdbool.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "../model/model.h"
+#include "playlist.h"
+
+static int nbPlaylistLevels;
+static char ** playlistPaths;
+
+// Index of the level being played, and of the level being prepared in the background
+static int currentLevel = -1;
+static int preparedLevel;
+
+static SDL_Thread * loaderThread;
+
+// Level published by the loader (NULL if its configuration file is not valid)
+static Game * loadedLevel;
+
+/**
+ * Main function of the loader: parses and checks the configuration file of the prepared level
+ * 
+ * @param data Unused
+ * 
+ * @return Always 0
+*/
+int loadLevel(void * data) {
+    Game * game = malloc(sizeof(Game));
+
+    if (!loadConfigFile(game, playlistPaths[preparedLevel])) {
+        printf("Level not loaded (%s).\n", playlistPaths[preparedLevel]);
+        free(game);
+        game = NULL;
+    }
+
+    SDL_AtomicSetPtr((void **) &loadedLevel, game);
+
+    return 0;
+}
+
+/**
+ * Start parsing the configuration file of a level in the background
+ * 
+ * @param level Index of the level in the playlist
+*/
+void prepareLevel(int level) {
+    preparedLevel = level;
+    loadedLevel = NULL;
+
+    loaderThread = SDL_CreateThread(loadLevel, "level loader", NULL);
+}
+
+/**
+ * Start preparing the first level of a playlist (while the window is created for instance)
+ * 
+ * @param nbLevels Number of levels
+ * @param levelPaths Paths of the configuration files of the levels, in the playing order
+*/
+void startPlaylist(int nbLevels, char ** levelPaths) {
+    nbPlaylistLevels = nbLevels;
+    playlistPaths = levelPaths;
+    currentLevel = -1;
+
+    prepareLevel(0);
+}
+
+/**
+ * Take the next level of the playlist and start preparing the one after it
+ * 
+ * @return The loaded game (to free with freeAllocations() and free()), NULL if no level is left
+*/
+Game * takeNextLevel() {
+    while (loaderThread != NULL) {
+        // The loader had the whole previous level to finish, so this rarely waits
+        SDL_WaitThread(loaderThread, NULL);
+        loaderThread = NULL;
+
+        Game * game = SDL_AtomicSetPtr((void **) &loadedLevel, NULL);
+        currentLevel = preparedLevel;
+
+        if (currentLevel + 1 < nbPlaylistLevels) {
+            prepareLevel(currentLevel + 1);
+        }
+
+        // Invalid levels are skipped
+        if (game != NULL) return game;
+    }
+
+    return NULL;
+}
+
+/**
+ * Get the configuration file of the level being played
+ * 
+ * @return Path of the file
+*/
+char * getCurrentLevelPath() {
+    return playlistPaths[currentLevel];
+}
+
+/**
+ * Stop preparing levels and free the one not played
+*/
+void stopPlaylist() {
+    if (loaderThread == NULL) return;
+
+    SDL_WaitThread(loaderThread, NULL);
+    loaderThread = NULL;
+
+    Game * game = SDL_AtomicSetPtr((void **) &loadedLevel, NULL);
+
+    if (game != NULL) {
+        freeAllocations(game);
+        free(game);
+    }
+}
@@ -0,0 +1,9 @@
+#ifndef PLAYLIST_H
+#define PLAYLIST_H
+
+void startPlaylist(int nbLevels, char ** levelPaths);
+Game * takeNextLevel();
+char * getCurrentLevelPath();
+void stopPlaylist();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include <stdbool.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "profiler.h"
+
+#ifdef __linux__
+
+#define NB_COUNTERS 4
+
+typedef struct {
+    int nbCalls;
+    double wallTime;
+
+    Uint64 counters[NB_COUNTERS];
+} PhaseProfile;
+
+static char * phaseNames[NB_PROFILED_PHASES] = {"events", "render", "physics"};
+static char * counterNames[NB_COUNTERS] = {"cycles", "instructions", "cache misses", "branch misses"};
+
+static bool profiling = false;
+
+// Descriptors of the opened counters (-1 if not available), the first opened one leading the group
+static int counterDescriptors[NB_COUNTERS] = {-1, -1, -1, -1};
+static int groupLeader = -1;
+
+// Position of each counter in the values read from the group (-1 if not available)
+static int counterIndexes[NB_COUNTERS];
+static int nbOpenedCounters = 0;
+
+static PhaseProfile profiles[NB_PROFILED_PHASES];
+
+// Values at the beginning of the current phase
+static Uint64 phaseStartCounters[NB_COUNTERS];
+static Uint64 phaseStartTime;
+
+/**
+ * Open a hardware counter of the main thread (user space only, so that no privilege is needed)
+ * 
+ * @param config Hardware event counted
+ * @param groupDescriptor Descriptor of the group leader, or -1 to lead a new group
+ * 
+ * @return Descriptor of the counter, or -1 if the counter is not available
+*/
+int openCounter(Uint64 config, int groupDescriptor) {
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = config;
+    attributes.disabled = groupDescriptor == -1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_GROUP;
+
+    return syscall(__NR_perf_event_open, &attributes, 0, -1, groupDescriptor, 0);
+}
+
+/**
+ * Read all the opened counters at once
+ * 
+ * @param values Values of the counters (0 for the ones not available)
+*/
+void readCounters(Uint64 values[NB_COUNTERS]) {
+    // Number of counters then their values
+    Uint64 buffer[1 + NB_COUNTERS] = {0};
+
+    if (read(groupLeader, buffer, sizeof(buffer)) <= 0) buffer[0] = 0;
+
+    for (int i = 0; i < NB_COUNTERS; i++) {
+        values[i] = counterIndexes[i] >= 0 && (Uint64) counterIndexes[i] < buffer[0] ? buffer[1 + counterIndexes[i]] : 0;
+    }
+}
+
+#endif
+
+/**
+ * Open the hardware counters (cycles, instructions, cache misses and branch misses)
+ * 
+ * @return True if at least one counter is available, false otherwise
+*/
+bool startProfiler() {
+#ifdef __linux__
+    Uint64 configs[NB_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+    // The counters missing on this processor are skipped
+    for (int i = 0; i < NB_COUNTERS; i++) {
+        counterDescriptors[i] = openCounter(configs[i], groupLeader);
+        counterIndexes[i] = -1;
+
+        if (counterDescriptors[i] < 0) continue;
+
+        if (groupLeader == -1) groupLeader = counterDescriptors[i];
+
+        counterIndexes[i] = nbOpenedCounters++;
+    }
+
+    if (groupLeader == -1) {
+        printf("Hardware performance counters are not available (see /proc/sys/kernel/perf_event_paranoid)\n");
+        return false;
+    }
+
+    ioctl(groupLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(groupLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+    profiling = true;
+    return true;
+#else
+    printf("Hardware performance counters are only available on Linux\n");
+    return false;
+#endif
+}
+
+/**
+ * Start measuring a phase of the main loop
+*/
+void beginProfiledPhase() {
+#ifdef __linux__
+    if (!profiling) return;
+
+    phaseStartTime = SDL_GetPerformanceCounter();
+    readCounters(phaseStartCounters);
+#endif
+}
+
+/**
+ * Stop measuring a phase of the main loop and add its counts to the ones of the phase
+ * 
+ * @param phase The phase
+*/
+void endProfiledPhase(ProfiledPhase phase) {
+#ifdef __linux__
+    if (!profiling) return;
+
+    Uint64 values[NB_COUNTERS];
+    readCounters(values);
+
+    PhaseProfile * profile = &profiles[phase];
+
+    for (int i = 0; i < NB_COUNTERS; i++) {
+        profile->counters[i] += values[i] - phaseStartCounters[i];
+    }
+
+    profile->wallTime += (SDL_GetPerformanceCounter() - phaseStartTime) * 1000.0 / SDL_GetPerformanceFrequency();
+    profile->nbCalls++;
+#endif
+}
+
+/**
+ * Print the counts of each phase and close the counters
+*/
+void stopProfiler() {
+#ifdef __linux__
+    if (!profiling) return;
+
+    printf("\n%-10s %8s %12s", "Phase", "Calls", "Time (ms)");
+
+    for (int i = 0; i < NB_COUNTERS; i++) {
+        if (counterIndexes[i] >= 0) printf(" %16s", counterNames[i]);
+    }
+
+    printf(" %8s %14s\n", "IPC", "Misses / kinst");
+
+    for (int phase = 0; phase < NB_PROFILED_PHASES; phase++) {
+        PhaseProfile profile = profiles[phase];
+
+        printf("%-10s %8d %12.2f", phaseNames[phase], profile.nbCalls, profile.wallTime);
+
+        for (int i = 0; i < NB_COUNTERS; i++) {
+            if (counterIndexes[i] >= 0) printf(" %16llu", (unsigned long long) profile.counters[i]);
+        }
+
+        // Instructions per cycle and cache misses per thousand instructions
+        Uint64 cycles = profile.counters[0];
+        Uint64 instructions = profile.counters[1];
+
+        printf(" %8.2f %14.2f\n", cycles > 0 ? (double) instructions / cycles : 0, instructions > 0 ? profile.counters[2] * 1000.0 / instructions : 0);
+    }
+
+    for (int i = 0; i < NB_COUNTERS; i++) {
+        if (counterDescriptors[i] >= 0) close(counterDescriptors[i]);
+
+        counterDescriptors[i] = -1;
+    }
+
+    groupLeader = -1;
+    profiling = false;
+#endif
+}
@@ -0,0 +1,16 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+typedef enum {
+    EVENTS_PROFILE,
+    RENDER_PROFILE,
+    PHYSICS_PROFILE,
+    NB_PROFILED_PHASES
+} ProfiledPhase;
+
+bool startProfiler();
+void beginProfiledPhase();
+void endProfiledPhase(ProfiledPhase phase);
+void stopProfiler();
+
+#endif
\ No newline at end of file
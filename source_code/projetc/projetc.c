@@ -0,0 +1,226 @@
+#include <stdbool.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "../model/model.h"
+#include "../snapshot/snapshot.h"
+#include "../worker_pool/worker_pool.h"
+#include "projetc.h"
+
+// Number of games stepped by a worker at once (below two of them, the calling thread steps them alone)
+#define PROJETC_GRAIN 8
+
+struct ProjetcEnv {
+    Game game;
+
+    // State of the game before its start, restored at each reset instead of parsing the file again
+    size_t initialStateSize;
+    unsigned char * initialState;
+
+    int outcome;
+};
+
+// Arguments of the running call, read by the workers
+static ProjetcEnv ** stepEnvs;
+static unsigned char * stepActions;
+static int stepNbEnvs;
+static float * stepObservations;
+static int * stepOutcomes;
+static SDL_atomic_t nextGroup;
+
+// Mutex created by the first call and kept until the end, serializing the steps, the start and the stop of the workers
+static SDL_SpinLock mutexLock = 0;
+static SDL_mutex * stepMutex = NULL;
+
+// Workers started by the first step, shared by all the games
+static WorkerPool * projetcPool = NULL;
+
+/**
+ * Copy what the spaceship sees of a game
+ * 
+ * @param env The game
+ * @param observation Receives PROJETC_OBSERVATION_SIZE floats
+*/
+static void writeObservation(ProjetcEnv * env, float * observation) {
+    Configuration configuration = getConfiguration(&env->game);
+    Spaceship spaceship = configuration.spaceship;
+
+    observation[0] = spaceship.position.posX;
+    observation[1] = spaceship.position.posY;
+    observation[2] = spaceship.velocity.vecX;
+    observation[3] = spaceship.velocity.vecY;
+    observation[4] = spaceship.gravity.vecX;
+    observation[5] = spaceship.gravity.vecY;
+    observation[6] = configuration.arrivalPoint.posX - spaceship.position.posX;
+    observation[7] = configuration.arrivalPoint.posY - spaceship.position.posY;
+}
+
+/**
+ * Create a game from a configuration file
+ * 
+ * @param path Path of the configuration file
+ * @param gravityCutoff Distance beyond which the bodies don't pull the spaceship (0 for no limit)
+ * 
+ * @return The game (to reset before stepping it), or NULL if the file is not valid
+*/
+ProjetcEnv * projetcCreateEnv(char * path, double gravityCutoff) {
+    ProjetcEnv * env = calloc(1, sizeof(ProjetcEnv));
+
+    if (!loadConfigFile(&env->game, path)) {
+        free(env);
+        return NULL;
+    }
+
+    setGravityCutoff(&env->game, gravityCutoff);
+
+    env->initialStateSize = getSnapshotSize(&env->game);
+    env->initialState = malloc(env->initialStateSize);
+
+    writeSnapshot(&env->game, env->initialState, env->initialStateSize);
+
+    env->outcome = PROJETC_LOSS;
+
+    return env;
+}
+
+/**
+ * Start a game again, the spaceship being launched at once
+ * 
+ * @param env The game
+ * @param seed Seed of the random numbers
+ * @param observation Receives the first observation (NULL if not needed)
+*/
+void projetcResetEnv(ProjetcEnv * env, unsigned int seed, float * observation) {
+    restoreSnapshot(&env->game, env->initialState, env->initialStateSize);
+
+    setSeed(&env->game, seed);
+
+    startTime(&env->game);
+    startGame(&env->game);
+
+    env->outcome = PROJETC_FLYING;
+
+    if (observation != NULL) writeObservation(env, observation);
+}
+
+/**
+ * Simulate a tick of a game (a finished game stays as it is until it is reset)
+ * 
+ * @param env The game
+ * @param action Keys held during the tick
+*/
+static void stepEnv(ProjetcEnv * env, unsigned char action) {
+    if (env->outcome != PROJETC_FLYING) return;
+
+    Game * game = &env->game;
+
+    game->leftKeyPressed  = action & PROJETC_ACTION_LEFT;
+    game->rightKeyPressed = action & PROJETC_ACTION_RIGHT;
+
+    advanceTime(game, TICK_DURATION);
+    rotatePlanets(game);
+    moveSpaceship(game);
+
+    // Winning and losing conditions checking
+    if (isGameWin(game)) {
+        env->outcome = PROJETC_WIN;
+    } else if (isGameLost(game)) {
+        env->outcome = PROJETC_LOSS;
+    }
+}
+
+/**
+ * Step groups of games of the running call until there is none left
+ * 
+ * @param thread Unused
+ * @param data Unused
+*/
+static void stepRemainingGroups(int thread, void * data) {
+    int group;
+
+    while ((group = SDL_AtomicAdd(&nextGroup, 1)) * PROJETC_GRAIN < stepNbEnvs) {
+        int last = (group + 1) * PROJETC_GRAIN < stepNbEnvs ? (group + 1) * PROJETC_GRAIN : stepNbEnvs;
+
+        for (int i = group * PROJETC_GRAIN; i < last; i++) {
+            stepEnv(stepEnvs[i], stepActions[i]);
+
+            writeObservation(stepEnvs[i], &stepObservations[i * PROJETC_OBSERVATION_SIZE]);
+
+            if (stepOutcomes != NULL) stepOutcomes[i] = stepEnvs[i]->outcome;
+        }
+    }
+}
+
+/**
+ * Get the mutex of the library, created by the first call
+ * 
+ * @return The mutex
+*/
+static SDL_mutex * getStepMutex() {
+    SDL_AtomicLock(&mutexLock);
+
+    if (stepMutex == NULL) {
+        stepMutex = SDL_CreateMutex();
+    }
+
+    SDL_AtomicUnlock(&mutexLock);
+
+    return stepMutex;
+}
+
+/**
+ * Simulate a tick of several games in parallel (the calls from several threads are run one after the other)
+ * 
+ * @param envs The games
+ * @param actions Keys held by each game (PROJETC_ACTION_LEFT and PROJETC_ACTION_RIGHT bits)
+ * @param nbEnvs Number of games
+ * @param observations Receives PROJETC_OBSERVATION_SIZE floats per game, one game after the other
+ * @param outcomes Receives the outcome of each game (NULL if not needed)
+*/
+void projetcStepMany(ProjetcEnv ** envs, unsigned char * actions, int nbEnvs, float * observations, int * outcomes) {
+    SDL_LockMutex(getStepMutex());
+
+    // Workers started if they aren't yet
+    if (projetcPool == NULL) projetcPool = createWorkerPool("projetc");
+
+    stepEnvs = envs;
+    stepActions = actions;
+    stepNbEnvs = nbEnvs;
+    stepObservations = observations;
+    stepOutcomes = outcomes;
+
+    SDL_AtomicSet(&nextGroup, 0);
+
+    // Waking up the workers only when there is work for several threads
+    int nbThreads = nbEnvs >= 2 * PROJETC_GRAIN ? getWorkerPoolSize(projetcPool) : 1;
+
+    runWorkerPool(projetcPool, nbThreads, stepRemainingGroups, NULL);
+
+    SDL_UnlockMutex(stepMutex);
+}
+
+/**
+ * Free a game
+ * 
+ * @param env The game
+*/
+void projetcFreeEnv(ProjetcEnv * env) {
+    freeAllocations(&env->game);
+
+    free(env->initialState);
+    free(env);
+}
+
+/**
+ * Stop the workers, once the running steps are over (the next step starts them again)
+*/
+void projetcShutdown() {
+    SDL_LockMutex(getStepMutex());
+
+    if (projetcPool != NULL) {
+        freeWorkerPool(projetcPool);
+        projetcPool = NULL;
+    }
+
+    SDL_UnlockMutex(stepMutex);
+}
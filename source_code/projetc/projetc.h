@@ -0,0 +1,36 @@
+#ifndef PROJETC_H
+#define PROJETC_H
+
+/* ------------------------------------------------------------ */
+/* Library running many games at once, for bots and experiments */
+/* ------------------------------------------------------------ */
+
+// Game owned by the caller, whose content is hidden
+typedef struct ProjetcEnv ProjetcEnv;
+
+// Number of floats of an observation : position, velocity and gravity of the spaceship, then offset to the arrival point
+#define PROJETC_OBSERVATION_SIZE 8
+
+// Bits of an action
+#define PROJETC_ACTION_LEFT  1
+#define PROJETC_ACTION_RIGHT 2
+
+// Outcomes of the games
+#define PROJETC_FLYING 0
+#define PROJETC_WIN    1
+#define PROJETC_LOSS   2
+
+// Only these functions are exported by libprojetc.so, built with -fvisibility=hidden
+#ifdef __GNUC__
+#define PROJETC_API __attribute__((visibility("default")))
+#else
+#define PROJETC_API
+#endif
+
+PROJETC_API ProjetcEnv * projetcCreateEnv(char * path, double gravityCutoff);
+PROJETC_API void projetcResetEnv(ProjetcEnv * env, unsigned int seed, float * observation);
+PROJETC_API void projetcStepMany(ProjetcEnv ** envs, unsigned char * actions, int nbEnvs, float * observations, int * outcomes);
+PROJETC_API void projetcFreeEnv(ProjetcEnv * env);
+PROJETC_API void projetcShutdown();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include <stdbool.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "../model/model.h"
+#include "server.h"
+
+#define MAX_PATH_LENGTH 512
+
+// Connections waiting to be accepted
+#define SERVER_BACKLOG 16
+
+// Delay in milliseconds before accepting again after a lack of resources (no descriptor or memory left)
+#define SERVER_ACCEPT_DELAY 100
+
+// Game driven by a connection
+typedef struct {
+    int socket;
+    double gravityCutoff;
+
+    bool loaded;
+    char path[MAX_PATH_LENGTH];
+    Game game;
+
+    Uint32 tick;
+    ServerOutcome outcome;
+} Session;
+
+#ifdef __linux__
+
+/**
+ * Receive an exact number of bytes
+ * 
+ * @param socket Socket of the connection
+ * @param buffer Buffer receiving the bytes
+ * @param size Number of bytes
+ * 
+ * @return True if all the bytes were received, false if the connection was closed
+*/
+bool receiveAll(int socket, void * buffer, size_t size) {
+    size_t received = 0;
+
+    while (received < size) {
+        ssize_t count = read(socket, (char *) buffer + received, size - received);
+
+        if (count <= 0) return false;
+
+        received += count;
+    }
+
+    return true;
+}
+
+/**
+ * Send an exact number of bytes (a client gone before reading only closes its own connection, without SIGPIPE)
+ * 
+ * @param socket Socket of the connection
+ * @param buffer Bytes to send
+ * @param size Number of bytes
+ * 
+ * @return True if all the bytes were sent, false if the connection was closed
+*/
+bool sendAll(int socket, void * buffer, size_t size) {
+    size_t sent = 0;
+
+    while (sent < size) {
+        ssize_t count = send(socket, (char *) buffer + sent, size - sent, MSG_NOSIGNAL);
+
+        if (count <= 0) return false;
+
+        sent += count;
+    }
+
+    return true;
+}
+
+#endif
+
+/**
+ * Start the loaded configuration again
+ * 
+ * @param session The session
+ * @param seed Seed of the random numbers
+ * 
+ * @return True if the configuration could be loaded again, false otherwise
+*/
+bool resetSession(Session * session, unsigned int seed) {
+    if (session->loaded) {
+        freeAllocations(&session->game);
+    }
+
+    session->loaded = loadConfigFile(&session->game, session->path);
+
+    if (!session->loaded) return false;
+
+    setSeed(&session->game, seed);
+    setGravityCutoff(&session->game, session->gravityCutoff);
+
+    // Launched at once, like in the batch mode
+    startTime(&session->game);
+    startGame(&session->game);
+
+    session->tick = 0;
+    session->outcome = FLYING_OUTCOME;
+
+    return true;
+}
+
+/**
+ * Simulate ticks of a session, with the same steps as the batch mode
+ * 
+ * @param session The session
+ * @param inputs Keys held during the ticks
+ * @param nbTicks Number of ticks (fewer if the game ends)
+*/
+void stepSession(Session * session, Uint8 inputs, Uint32 nbTicks) {
+    Game * game = &session->game;
+
+    game->leftKeyPressed  = inputs & SERVER_INPUT_LEFT;
+    game->rightKeyPressed = inputs & SERVER_INPUT_RIGHT;
+
+    for (Uint32 i = 0; i < nbTicks && session->outcome == FLYING_OUTCOME; i++) {
+        advanceTime(game, TICK_DURATION);
+        rotatePlanets(game);
+        moveSpaceship(game);
+
+        session->tick++;
+
+        // Winning and losing conditions checking
+        if (isGameWin(game)) {
+            session->outcome = WIN_OUTCOME;
+        } else if (isGameLost(game)) {
+            session->outcome = LOSS_OUTCOME;
+        }
+    }
+}
+
+/**
+ * Apply a request to a session
+ * 
+ * @param session The session
+ * @param request The request
+ * @param state Receives the state to answer
+ * 
+ * @return True if the request can be answered, false if the connection must be closed
+*/
+bool handleRequest(Session * session, ServerRequest request, ServerState * state) {
+    bool applied = false;
+
+    switch (request.command) {
+        case LOAD_COMMAND:
+            if (request.length >= MAX_PATH_LENGTH) return false;
+
+#ifdef __linux__
+            if (!receiveAll(session->socket, session->path, request.length)) return false;
+#endif
+
+            session->path[request.length] = '\0';
+
+            applied = resetSession(session, request.argument);
+            break;
+
+        case RESET_COMMAND:
+            applied = session->path[0] != '\0' && resetSession(session, request.argument);
+            break;
+
+        case STEP_COMMAND:
+            if (session->loaded && request.argument <= SERVER_MAX_TICKS) {
+                stepSession(session, request.inputs, request.argument);
+                applied = true;
+            }
+            break;
+
+        case STATE_COMMAND:
+            applied = session->loaded;
+            break;
+
+        default:
+            return false;
+    }
+
+    *state = (ServerState) {0};
+    state->status = !applied;
+
+    if (session->loaded) {
+        Configuration configuration = getConfiguration(&session->game);
+
+        state->outcome = session->outcome;
+        state->tick = session->tick;
+        state->positionX = configuration.spaceship.position.posX;
+        state->positionY = configuration.spaceship.position.posY;
+        state->velocityX = configuration.spaceship.velocity.vecX;
+        state->velocityY = configuration.spaceship.velocity.vecY;
+        state->score = configuration.score;
+        state->elapsedTime = session->game.elapsedTime;
+    }
+
+    return true;
+}
+
+/**
+ * Main function of a connection: answers its requests until it is closed
+ * 
+ * @param data The session of the connection
+ * 
+ * @return Always 0
+*/
+int sessionWorker(void * data) {
+    Session * session = data;
+
+#ifdef __linux__
+    ServerRequest request;
+    ServerState state;
+
+    while (receiveAll(session->socket, &request, sizeof(request))) {
+        if (!handleRequest(session, request, &state) || !sendAll(session->socket, &state, sizeof(state))) break;
+    }
+
+    close(session->socket);
+#endif
+
+    if (session->loaded) {
+        freeAllocations(&session->game);
+    }
+
+    free(session);
+
+    return 0;
+}
+
+/**
+ * Main function of the headless server: each connection to the socket drives its own game
+ * 
+ * @param argc Number of arguments (after --serve)
+ * @param argv Path of the socket then the options
+ * 
+ * @return Exit code of the program
+*/
+int runServer(int argc, char * argv[]) {
+#ifdef __linux__
+    if (argc < 1) {
+        printf("Usage : --serve <socket path> [--gravity-cutoff R]\n");
+        return 1;
+    }
+
+    char * socketPath = argv[0];
+    double gravityCutoff = 0;
+
+    // Command line options reading
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--gravity-cutoff") && i + 1 < argc) {
+            gravityCutoff = atof(argv[++i]);
+        } else {
+            printf("Unknown option (%s)\n", argv[i]);
+            return 1;
+        }
+    }
+
+    struct sockaddr_un address = {0};
+    address.sun_family = AF_UNIX;
+
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        printf("Socket path too long (%s)\n", socketPath);
+        return 1;
+    }
+
+    strcpy(address.sun_path, socketPath);
+
+    int serverSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    // A socket left by a previous server is replaced
+    unlink(socketPath);
+
+    if (serverSocket < 0 || bind(serverSocket, (struct sockaddr *) &address, sizeof(address)) < 0 || listen(serverSocket, SERVER_BACKLOG) < 0) {
+        printf("The socket %s cannot be opened\n", socketPath);
+        return 1;
+    }
+
+    printf("Listening on %s\n", socketPath);
+
+    while (true) {
+        int clientSocket = accept(serverSocket, NULL, NULL);
+
+        if (clientSocket < 0) {
+            // Waiting for connections to close rather than failing again at once
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                SDL_Delay(SERVER_ACCEPT_DELAY);
+            }
+
+            continue;
+        }
+
+        Session * session = calloc(1, sizeof(Session));
+        session->socket = clientSocket;
+        session->gravityCutoff = gravityCutoff;
+
+        // The games of the connections are independent, so they run in parallel
+        SDL_DetachThread(SDL_CreateThread(sessionWorker, "session", session));
+    }
+#else
+    printf("The server mode is only available on Linux\n");
+    return 1;
+#endif
+}
@@ -0,0 +1,66 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+/* -------------------------------------------------- */
+/* Protocol of the control socket (native byte order) */
+/* -------------------------------------------------- */
+
+typedef enum {
+    // Load the configuration file whose path follows the request, then reset with the seed given as argument
+    LOAD_COMMAND = 1,
+
+    // Start the loaded configuration again, with the seed given as argument
+    RESET_COMMAND,
+
+    // Apply the inputs, then simulate as many ticks as the argument (fewer if the game ends)
+    STEP_COMMAND,
+
+    // Only return the state
+    STATE_COMMAND
+} ServerCommand;
+
+// Largest number of ticks of a step (a step asking for more isn't applied)
+#define SERVER_MAX_TICKS 100000
+
+// Bits of the inputs of a step
+#define SERVER_INPUT_LEFT  1
+#define SERVER_INPUT_RIGHT 2
+
+typedef struct {
+    Uint8 command;
+    Uint8 inputs;
+    Uint16 reserved;
+
+    // Seed or number of ticks
+    Uint32 argument;
+
+    // Number of bytes following the request (the path of a load)
+    Uint32 length;
+} ServerRequest;
+
+typedef enum {
+    FLYING_OUTCOME,
+    WIN_OUTCOME,
+    LOSS_OUTCOME
+} ServerOutcome;
+
+// Answer to every request
+typedef struct {
+    // 0 if the request was applied, 1 otherwise
+    Uint8 status;
+    Uint8 outcome;
+    Uint16 reserved;
+
+    // Ticks simulated since the last reset
+    Uint32 tick;
+
+    double positionX, positionY;
+    double velocityX, velocityY;
+
+    Sint32 score;
+    Uint32 elapsedTime;
+} ServerState;
+
+int runServer(int argc, char * argv[]);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,354 @@
+#include <stdbool.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "../model/model.h"
+#include "snapshot.h"
+
+#define SNAPSHOT_MAGIC 0x4E534350
+#define SNAPSHOT_VERSION 3
+
+typedef struct {
+    // Bytes of the snapshot (NULL to only measure it)
+    unsigned char * data;
+    size_t size;
+    size_t offset;
+
+    bool reading;
+    bool overflow;
+} SnapshotBuffer;
+
+/**
+ * Copy bytes between a value of the game and the snapshot, in the direction of the buffer
+ * 
+ * @param buffer The snapshot buffer
+ * @param value Address of the value
+ * @param size Size of the value
+*/
+void transferBytes(SnapshotBuffer * buffer, void * value, size_t size) {
+    if (buffer->overflow || (buffer->data != NULL && buffer->offset + size > buffer->size)) {
+        buffer->overflow = true;
+        return;
+    }
+
+    if (buffer->data != NULL) {
+        if (buffer->reading) {
+            memcpy(value, buffer->data + buffer->offset, size);
+        } else {
+            memcpy(buffer->data + buffer->offset, value, size);
+        }
+    }
+
+    buffer->offset += size;
+}
+
+#define TRANSFER(buffer, value) transferBytes(buffer, &(value), sizeof(value))
+
+/**
+ * Copy a position between the game and the snapshot
+*/
+void transferPosition(SnapshotBuffer * buffer, Position * position) {
+    TRANSFER(buffer, position->posX);
+    TRANSFER(buffer, position->posY);
+}
+
+/**
+ * Copy a vector between the game and the snapshot
+*/
+void transferVector(SnapshotBuffer * buffer, Vector * vector) {
+    TRANSFER(buffer, vector->vecX);
+    TRANSFER(buffer, vector->vecY);
+}
+
+/**
+ * Copy a list of bodies between the game and the snapshot (allocated while reading)
+ * 
+ * @param buffer The snapshot buffer
+ * @param nbBodies Number of bodies of the list
+ * @param bodies The list
+ * 
+ * @return False if the number of bodies read is not valid, true otherwise
+*/
+bool transferBodies(SnapshotBuffer * buffer, int * nbBodies, BodyReference ** bodies) {
+    TRANSFER(buffer, *nbBodies);
+
+    if (buffer->reading) {
+        if (buffer->overflow || *nbBodies < 0 || (size_t) *nbBodies > buffer->size - buffer->offset) return false;
+
+        *bodies = calloc(*nbBodies, sizeof(BodyReference));
+    }
+
+    for (int i = 0; i < *nbBodies; i++) {
+        TRANSFER(buffer, (*bodies)[i].solarSystem);
+        TRANSFER(buffer, (*bodies)[i].planet);
+    }
+
+    return true;
+}
+
+/**
+ * Copy the whole state of a game between the game and the snapshot, field by field so that the layout never depends on padding
+ * 
+ * While reading, the game must be empty and receives newly allocated lists
+ * 
+ * @param buffer The snapshot buffer
+ * @param game The game
+ * 
+ * @return False if the snapshot is not valid, true otherwise
+*/
+bool transferGame(SnapshotBuffer * buffer, Game * game) {
+    Configuration * configuration = &game->configuration;
+    Spaceship * spaceship = &configuration->spaceship;
+
+    unsigned int magic = SNAPSHOT_MAGIC;
+    unsigned int version = SNAPSHOT_VERSION;
+
+    // Snapshots of the single precision build can't be restored by the double precision one, and vice versa
+    unsigned char realSize = sizeof(Real);
+
+    TRANSFER(buffer, magic);
+    TRANSFER(buffer, version);
+    TRANSFER(buffer, realSize);
+
+    if (buffer->reading && (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION || realSize != sizeof(Real))) return false;
+
+    // Clock, inputs and random numbers generator
+    TRANSFER(buffer, game->elapsedTime);
+    TRANSFER(buffer, game->leftKeyPressed);
+    TRANSFER(buffer, game->rightKeyPressed);
+    TRANSFER(buffer, game->steeringCos);
+    TRANSFER(buffer, game->steeringSin);
+    TRANSFER(buffer, game->randomState);
+    TRANSFER(buffer, game->gravityCutoff);
+
+    // Dimensions and points
+    TRANSFER(buffer, configuration->winWidth);
+    TRANSFER(buffer, configuration->winHeight);
+    TRANSFER(buffer, configuration->worldWidth);
+    TRANSFER(buffer, configuration->worldHeight);
+    transferPosition(buffer, &configuration->startingPoint);
+    transferPosition(buffer, &configuration->arrivalPoint);
+    TRANSFER(buffer, configuration->score);
+
+    // Spaceship
+    transferPosition(buffer, &spaceship->position);
+    transferVector(buffer, &spaceship->velocity);
+    transferVector(buffer, &spaceship->gravity);
+    TRANSFER(buffer, spaceship->weight);
+    TRANSFER(buffer, spaceship->minSpeed);
+    TRANSFER(buffer, spaceship->maxSpeed);
+
+    // Neighbors of the spaceship, so that the gravity is summed over the same bodies
+    transferPosition(buffer, &spaceship->neighbors.origin);
+    TRANSFER(buffer, spaceship->neighbors.upToDate);
+
+    if (!transferBodies(buffer, &spaceship->neighbors.nbBodies, &spaceship->neighbors.bodies)) return false;
+
+    spaceship->neighbors.capacity = spaceship->neighbors.nbBodies;
+
+    // Solar systems
+    TRANSFER(buffer, configuration->nbStars);
+    TRANSFER(buffer, configuration->nbSolarSystems);
+
+    if (buffer->reading) {
+        int nbPlanets = configuration->nbStars - configuration->nbSolarSystems;
+
+        // Each object takes at least one byte, so no count can exceed the remaining size
+        if (buffer->overflow || configuration->nbSolarSystems < 0 || nbPlanets < 0 || (size_t) configuration->nbStars > buffer->size - buffer->offset) {
+            configuration->nbSolarSystems = 0;
+            return false;
+        }
+
+        // All the bodies in a single block, like when loading a configuration file
+        if (!allocateSolarSystems(configuration, configuration->nbSolarSystems, nbPlanets)) {
+            configuration->nbSolarSystems = 0;
+            return false;
+        }
+    }
+
+    // Iterate through all the solar systems
+    for (int i = 0; i < configuration->nbSolarSystems; i++) {
+        SolarSystem * solarSystem = &configuration->solarSystems[i];
+
+        transferPosition(buffer, &solarSystem->sun.position);
+        TRANSFER(buffer, solarSystem->sun.radius);
+        TRANSFER(buffer, solarSystem->nbPlanets);
+
+        if (buffer->reading) {
+            if (!buffer->overflow && solarSystem->nbPlanets >= 0) {
+                solarSystem->planets = allocatePlanets(configuration, solarSystem->nbPlanets);
+            }
+
+            // More planets than counted in the number of bodies
+            if (solarSystem->planets == NULL) {
+                solarSystem->nbPlanets = 0;
+                return false;
+            }
+        }
+
+        // Iterate through all the planets
+        for (int j = 0; j < solarSystem->nbPlanets; j++) {
+            transferPosition(buffer, &solarSystem->planets[j].position);
+            TRANSFER(buffer, solarSystem->planets[j].radius);
+            TRANSFER(buffer, solarSystem->planets[j].orbit);
+            TRANSFER(buffer, solarSystem->planets[j].eccentricity);
+            TRANSFER(buffer, solarSystem->planets[j].periapsis);
+            TRANSFER(buffer, solarSystem->planets[j].phase);
+            TRANSFER(buffer, solarSystem->planets[j].periapsisX);
+            TRANSFER(buffer, solarSystem->planets[j].periapsisY);
+        }
+    }
+
+    return !buffer->overflow;
+}
+
+/**
+ * Check that a restored game can be played (a corrupted snapshot can still have the right size)
+ * 
+ * @param game The restored game
+ * 
+ * @return True if the world has a size and the neighbors of the spaceship exist, false otherwise
+*/
+bool isRestoredGameValid(Game * game) {
+    Configuration * configuration = &game->configuration;
+    NeighborList * neighbors = &configuration->spaceship.neighbors;
+
+    if (configuration->worldWidth <= 0 || configuration->worldHeight <= 0) return false;
+
+    // The gravity is summed over these bodies without checking them again
+    for (int i = 0; i < neighbors->nbBodies; i++) {
+        BodyReference body = neighbors->bodies[i];
+
+        if (body.solarSystem < 0 || body.solarSystem >= configuration->nbSolarSystems) return false;
+        if (body.planet < -1 || body.planet >= configuration->solarSystems[body.solarSystem].nbPlanets) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Calculate the size of the snapshot of a game
+ * 
+ * @param game The game
+ * 
+ * @return Size of the snapshot (in bytes)
+*/
+size_t getSnapshotSize(Game * game) {
+    SnapshotBuffer buffer = {NULL, 0, 0, false, false};
+
+    transferGame(&buffer, game);
+
+    return buffer.offset;
+}
+
+/**
+ * Write the whole state of a game in a buffer (the chunks are left out since they are rebuilt)
+ * 
+ * @param game The game
+ * @param data The buffer
+ * @param capacity Size of the buffer
+ * 
+ * @return Size of the snapshot or 0 if the buffer is too small
+*/
+size_t writeSnapshot(Game * game, unsigned char * data, size_t capacity) {
+    SnapshotBuffer buffer = {data, capacity, 0, false, false};
+
+    if (!transferGame(&buffer, game)) return 0;
+
+    return buffer.offset;
+}
+
+/**
+ * Replace the state of a game by a snapshot, the game going on exactly like the one the snapshot was written from
+ * 
+ * @param game The game, left untouched if the snapshot is not valid
+ * @param data The snapshot
+ * @param size Size of the snapshot
+ * 
+ * @return True if the snapshot was restored, false otherwise
+*/
+bool restoreSnapshot(Game * game, unsigned char * data, size_t size) {
+    SnapshotBuffer buffer = {data, size, 0, true, false};
+
+    Game restoredGame = {0};
+
+    if (!transferGame(&buffer, &restoredGame) || buffer.offset != size || !isRestoredGameValid(&restoredGame)) {
+        freeAllocations(&restoredGame);
+        return false;
+    }
+
+    // The trail isn't part of the state, it stays with the game but starts over from the restored position
+    Trail * trail = game->trail;
+    clearTrail(trail);
+
+    freeAllocations(game);
+    *game = restoredGame;
+    game->trail = trail;
+
+    // The chunks only depend on the bodies, but building them marks the neighbors as outdated
+    bool neighborsUpToDate = game->configuration.spaceship.neighbors.upToDate;
+
+    buildChunks(game);
+
+    game->configuration.spaceship.neighbors.upToDate = neighborsUpToDate;
+
+    return true;
+}
+
+/**
+ * Write the snapshot of a game in a file
+ * 
+ * @param game The game
+ * @param path Path of the file
+ * 
+ * @return True if the file was written, false otherwise
+*/
+bool saveSnapshotFile(Game * game, char * path) {
+    size_t size = getSnapshotSize(game);
+    unsigned char * data = malloc(size);
+
+    writeSnapshot(game, data, size);
+
+    FILE * file = fopen(path, "wb");
+
+    bool saved = file != NULL && fwrite(data, 1, size, file) == size;
+
+    if (file != NULL) fclose(file);
+    free(data);
+
+    if (!saved) printf("Can't write the snapshot file (%s).\n", path);
+
+    return saved;
+}
+
+/**
+ * Restore a game from a snapshot file
+ * 
+ * @param game The game, left untouched if the file is not valid
+ * @param path Path of the file
+ * 
+ * @return True if the snapshot was restored, false otherwise
+*/
+bool loadSnapshotFile(Game * game, char * path) {
+    FILE * file = fopen(path, "rb");
+
+    if (file == NULL) {
+        printf("Can't open the snapshot file (%s).\n", path);
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char * data = malloc(size > 0 ? size : 1);
+
+    bool restored = size > 0 && fread(data, 1, size, file) == (size_t) size && restoreSnapshot(game, data, size);
+
+    fclose(file);
+    free(data);
+
+    if (!restored) printf("Snapshot file error (%s).\n", path);
+
+    return restored;
+}
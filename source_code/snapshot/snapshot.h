@@ -0,0 +1,11 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+size_t getSnapshotSize(Game * game);
+size_t writeSnapshot(Game * game, unsigned char * data, size_t capacity);
+bool restoreSnapshot(Game * game, unsigned char * data, size_t size);
+
+bool saveSnapshotFile(Game * game, char * path);
+bool loadSnapshotFile(Game * game, char * path);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include <stdbool.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "../model/model.h"
+#include "telemetry_ring.h"
+#include "telemetry.h"
+
+static char segmentName[256];
+static TelemetryRing * ring = NULL;
+
+// Number of records published (only this thread writes the counter, so it is kept here too)
+static Uint32 nbPublished;
+
+/**
+ * Create the shared memory segment of the telemetry and start a new session in it
+ * 
+ * @param name Name of the segment (starting with a /, like /projetc)
+ * 
+ * @return True if the segment is ready, false otherwise
+*/
+bool startTelemetry(char * name) {
+#ifdef __linux__
+    int descriptor = shm_open(name, O_CREAT | O_RDWR, 0644);
+
+    if (descriptor < 0 || ftruncate(descriptor, sizeof(TelemetryRing)) < 0) {
+        printf("The telemetry segment %s cannot be created\n", name);
+        if (descriptor >= 0) close(descriptor);
+        return false;
+    }
+
+    ring = mmap(NULL, sizeof(TelemetryRing), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+
+    if (ring == MAP_FAILED) {
+        printf("The telemetry segment %s cannot be mapped\n", name);
+        ring = NULL;
+        return false;
+    }
+
+    snprintf(segmentName, sizeof(segmentName), "%s", name);
+
+    // The readers still attached to a previous session start over
+    SDL_AtomicSet(&ring->running, 0);
+    SDL_AtomicSet(&ring->count, 0);
+
+    ring->version = TELEMETRY_VERSION;
+    ring->capacity = TELEMETRY_CAPACITY;
+    ring->recordSize = sizeof(TelemetryRecord);
+    ring->session = getpid() ^ SDL_GetTicks();
+    nbPublished = 0;
+
+    // The header is complete before a reader can see the magic number
+    SDL_MemoryBarrierRelease();
+    ring->magic = TELEMETRY_MAGIC;
+    SDL_AtomicSet(&ring->running, 1);
+
+    return true;
+#else
+    printf("The telemetry is only available on Linux\n");
+    return false;
+#endif
+}
+
+/**
+ * Publish the state of the game after a tick (a slow or absent reader never blocks it, the oldest records are overwritten)
+ * 
+ * @param game The game
+ * @param physicsTime Duration of the physics phase of the last frame
+ * @param renderTime Duration of the render phase of the last frame
+ * @param presentTime Duration of the present phase of the last frame
+*/
+void publishTelemetry(Game * game, float physicsTime, float renderTime, float presentTime) {
+    if (ring == NULL) return;
+
+    Configuration configuration = getConfiguration(game);
+    Spaceship spaceship = configuration.spaceship;
+
+    // Written in place, in the slot the readers will copy
+    TelemetryRecord * record = &ring->records[nbPublished % TELEMETRY_CAPACITY];
+
+    record->tick = nbPublished;
+    record->elapsedTime = game->elapsedTime;
+    record->positionX = spaceship.position.posX;
+    record->positionY = spaceship.position.posY;
+    record->velocityX = spaceship.velocity.vecX;
+    record->velocityY = spaceship.velocity.vecY;
+    record->gravityX = spaceship.gravity.vecX;
+    record->gravityY = spaceship.gravity.vecY;
+    record->score = configuration.score;
+    record->physicsTime = physicsTime;
+    record->renderTime = renderTime;
+    record->presentTime = presentTime;
+
+    // The record is complete before the counter shows it
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&ring->count, ++nbPublished);
+}
+
+/**
+ * End the session and remove the segment (the attached readers keep it until they close it)
+*/
+void stopTelemetry() {
+#ifdef __linux__
+    if (ring == NULL) return;
+
+    SDL_AtomicSet(&ring->running, 0);
+
+    munmap(ring, sizeof(TelemetryRing));
+    shm_unlink(segmentName);
+
+    ring = NULL;
+#endif
+}
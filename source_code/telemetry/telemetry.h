@@ -0,0 +1,8 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+bool startTelemetry(char * name);
+void publishTelemetry(Game * game, float physicsTime, float renderTime, float presentTime);
+void stopTelemetry();
+
+#endif
\ No newline at end of file
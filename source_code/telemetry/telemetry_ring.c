@@ -0,0 +1,117 @@
+#include <stdbool.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "telemetry_ring.h"
+
+/**
+ * Attach to the telemetry segment of a game
+ * 
+ * @param name Name of the segment (the one given to --telemetry)
+ * @param fromStart True to read the records still in the ring, false to read only the next ones
+ * 
+ * @return The reader, or NULL if the segment doesn't exist or isn't a telemetry ring
+*/
+TelemetryReader * openTelemetryRing(char * name, bool fromStart) {
+#ifdef __linux__
+    int descriptor = shm_open(name, O_RDONLY, 0);
+
+    if (descriptor < 0) return NULL;
+
+    TelemetryRing * ring = mmap(NULL, sizeof(TelemetryRing), PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+
+    if (ring == MAP_FAILED) return NULL;
+
+    // Another program, or another version of the layout
+    if (ring->magic != TELEMETRY_MAGIC || ring->version != TELEMETRY_VERSION || ring->recordSize != sizeof(TelemetryRecord)) {
+        munmap(ring, sizeof(TelemetryRing));
+        return NULL;
+    }
+
+    SDL_MemoryBarrierAcquire();
+
+    TelemetryReader * reader = malloc(sizeof(TelemetryReader));
+
+    reader->ring = ring;
+    reader->session = ring->session;
+    reader->nbLost = 0;
+
+    Uint32 count = SDL_AtomicGet(&ring->count);
+
+    // Half of the ring at most, so that the first records aren't overwritten while they are read
+    if (!fromStart) {
+        reader->next = count;
+    } else if (count > TELEMETRY_CAPACITY / 2) {
+        reader->next = count - TELEMETRY_CAPACITY / 2;
+    } else {
+        reader->next = 0;
+    }
+
+    return reader;
+#else
+    return NULL;
+#endif
+}
+
+/**
+ * Copy the next record published by the game, without ever blocking it
+ * 
+ * @param reader The reader
+ * @param record Receives the record
+ * 
+ * @return TELEMETRY_RECORD if a record was copied, TELEMETRY_EMPTY if there is no new one yet, TELEMETRY_STOPPED if the game stopped publishing
+*/
+TelemetryStatus readTelemetryRing(TelemetryReader * reader, TelemetryRecord * record) {
+    TelemetryRing * ring = reader->ring;
+
+    while (true) {
+        // The game started a new session: its counter started over
+        if (ring->session != reader->session) {
+            reader->session = ring->session;
+            reader->next = 0;
+        }
+
+        Uint32 count = SDL_AtomicGet(&ring->count);
+        SDL_MemoryBarrierAcquire();
+
+        if (count == reader->next) {
+            return SDL_AtomicGet(&ring->running) ? TELEMETRY_EMPTY : TELEMETRY_STOPPED;
+        }
+
+        // Too far behind: the records not overwritten yet are skipped to as well, with some margin
+        if (count - reader->next > TELEMETRY_CAPACITY / 2) {
+            reader->nbLost += count - TELEMETRY_CAPACITY / 2 - reader->next;
+            reader->next = count - TELEMETRY_CAPACITY / 2;
+        }
+
+        *record = ring->records[reader->next % TELEMETRY_CAPACITY];
+
+        // The copy is valid if the game didn't reach its slot again meanwhile
+        SDL_MemoryBarrierAcquire();
+
+        if (SDL_AtomicGet(&ring->count) - reader->next < TELEMETRY_CAPACITY && ring->session == reader->session) {
+            reader->next++;
+            return TELEMETRY_RECORD;
+        }
+    }
+}
+
+/**
+ * Detach from the telemetry segment
+ * 
+ * @param reader The reader
+*/
+void closeTelemetryRing(TelemetryReader * reader) {
+#ifdef __linux__
+    munmap(reader->ring, sizeof(TelemetryRing));
+#endif
+
+    free(reader);
+}
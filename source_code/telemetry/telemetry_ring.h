@@ -0,0 +1,68 @@
+#ifndef TELEMETRY_RING_H
+#define TELEMETRY_RING_H
+
+// Layout of the shared memory segment, read by the external tools
+#define TELEMETRY_MAGIC 0x4D4C4554
+#define TELEMETRY_VERSION 1
+
+// Number of records kept in the ring (a power of two, so that the slots stay the same when the counter wraps)
+#define TELEMETRY_CAPACITY 4096
+
+typedef struct {
+    // Index of the tick since the start of the session, and time of the game in milliseconds
+    Uint32 tick;
+    Uint32 elapsedTime;
+
+    double positionX, positionY;
+    double velocityX, velocityY;
+    double gravityX, gravityY;
+
+    Sint32 score;
+
+    // Durations in milliseconds of the phases of the last complete frame
+    float physicsTime;
+    float renderTime;
+    float presentTime;
+} TelemetryRecord;
+
+typedef struct {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 capacity;
+    Uint32 recordSize;
+
+    // Changes each time the game starts publishing again (the counter is reset)
+    Uint32 session;
+
+    // 1 while the game publishes
+    SDL_atomic_t running;
+
+    // Number of records published since the start of the session (the last one is at (count - 1) % capacity)
+    SDL_atomic_t count;
+
+    TelemetryRecord records[TELEMETRY_CAPACITY];
+} TelemetryRing;
+
+typedef enum {
+    TELEMETRY_RECORD,
+    TELEMETRY_EMPTY,
+    TELEMETRY_STOPPED
+} TelemetryStatus;
+
+typedef struct {
+    TelemetryRing * ring;
+
+    Uint32 session;
+
+    // Index of the next record to read
+    Uint32 next;
+
+    // Number of records overwritten before they could be read
+    Uint32 nbLost;
+} TelemetryReader;
+
+TelemetryReader * openTelemetryRing(char * name, bool fromStart);
+TelemetryStatus readTelemetryRing(TelemetryReader * reader, TelemetryRecord * record);
+void closeTelemetryRing(TelemetryReader * reader);
+
+#endif
\ No newline at end of file
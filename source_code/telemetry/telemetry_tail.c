@@ -0,0 +1,79 @@
+#include <stdbool.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "telemetry_ring.h"
+
+// Delay in milliseconds between two checks of an empty ring
+#define TAIL_POLL_DELAY 5
+
+/**
+ * Print a record on one line
+ * 
+ * @param record The record
+*/
+void printTelemetryRecord(TelemetryRecord record) {
+    printf(
+        "%8u %9u %9.2f %9.2f %7.3f %7.3f %8.4f %8.4f %6d %7.2f %7.2f %7.2f\n",
+        record.tick, record.elapsedTime,
+        record.positionX, record.positionY,
+        record.velocityX, record.velocityY,
+        record.gravityX, record.gravityY,
+        record.score,
+        record.physicsTime, record.renderTime, record.presentTime
+    );
+}
+
+/**
+ * Main function of the tool following the telemetry of a game
+*/
+int main(int argc, char * argv[]) {
+    char * name = "/projetc";
+    bool fromStart = false;
+
+    // Command line options reading
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--from-start")) {
+            fromStart = true;
+        } else if (argv[i][0] == '/') {
+            name = argv[i];
+        } else {
+            printf("Usage : %s [/segment_name] [--from-start]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    TelemetryReader * reader = openTelemetryRing(name, fromStart);
+
+    if (reader == NULL) {
+        printf("No telemetry in %s (start the game with --telemetry %s)\n", name, name);
+        return 1;
+    }
+
+    printf("%8s %9s %9s %9s %7s %7s %8s %8s %6s %7s %7s %7s\n", "Tick", "Time", "X", "Y", "VX", "VY", "GX", "GY", "Score", "Physics", "Render", "Present");
+
+    TelemetryRecord record;
+    TelemetryStatus status;
+    Uint32 nbLost = 0;
+
+    while ((status = readTelemetryRing(reader, &record)) != TELEMETRY_STOPPED) {
+        if (status == TELEMETRY_EMPTY) {
+            fflush(stdout);
+            SDL_Delay(TAIL_POLL_DELAY);
+            continue;
+        }
+
+        if (reader->nbLost != nbLost) {
+            printf("(%u records lost)\n", reader->nbLost - nbLost);
+            nbLost = reader->nbLost;
+        }
+
+        printTelemetryRecord(record);
+    }
+
+    printf("The game stopped publishing\n");
+
+    closeTelemetryRing(reader);
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include <stdbool.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "../model/model.h"
+#include "../snapshot/snapshot.h"
+#include "timeline.h"
+
+// Number of ticks between two keyframes (at most as many ticks to simulate again when seeking)
+#define KEYFRAME_INTERVAL 60
+
+// Memory of the keyframes beyond which the recording stops
+#define TIMELINE_MAX_MEMORY (256 * 1024 * 1024)
+
+// Inputs of a tick
+#define TICK_LEFT  1
+#define TICK_RIGHT 2
+#define TICK_START 4
+
+typedef struct {
+    unsigned int elapsedTime;
+    unsigned char inputs;
+} TickRecord;
+
+static int nbRecords;
+static int recordsCapacity;
+static TickRecord * records;
+
+// Whole states of the game every KEYFRAME_INTERVAL ticks, the first one being taken at the start of the timeline
+static size_t keyframeSize;
+static int nbKeyframes;
+static int keyframesCapacity;
+static unsigned char * keyframes;
+
+// Tick reached by the game, lower than nbRecords after seeking back
+static int currentTick;
+
+static bool startPending;
+static int startTick;
+
+static bool recording = false;
+
+/**
+ * Start recording a new timeline from the current state of the game
+ * 
+ * @param game The game
+*/
+void startTimeline(Game * game) {
+    nbRecords = 0;
+    nbKeyframes = 0;
+    currentTick = 0;
+
+    startPending = false;
+    startTick = -1;
+
+    keyframeSize = getSnapshotSize(game);
+
+    if (keyframesCapacity == 0) {
+        keyframesCapacity = 16;
+        keyframes = malloc(keyframesCapacity * keyframeSize);
+    } else {
+        keyframes = realloc(keyframes, keyframesCapacity * keyframeSize);
+    }
+
+    if (recordsCapacity == 0) {
+        recordsCapacity = 1024;
+        records = malloc(recordsCapacity * sizeof(TickRecord));
+    }
+
+    writeSnapshot(game, keyframes, keyframeSize);
+    nbKeyframes = 1;
+
+    recording = true;
+}
+
+/**
+ * Note that the spaceship was launched since the last tick
+*/
+void recordGameStart() {
+    startPending = true;
+}
+
+/**
+ * Record a tick that was just simulated (the ticks after it are forgotten if the game went back in time)
+ * 
+ * @param game The game
+*/
+void recordTick(Game * game) {
+    if (!recording) return;
+
+    // A new future replaces the one after the reached tick
+    if (currentTick < nbRecords) {
+        nbRecords = currentTick;
+        nbKeyframes = currentTick / KEYFRAME_INTERVAL + 1;
+
+        if (startTick >= currentTick) startTick = -1;
+    }
+
+    if (nbRecords == recordsCapacity) {
+        recordsCapacity *= 2;
+        records = realloc(records, recordsCapacity * sizeof(TickRecord));
+    }
+
+    TickRecord record = {game->elapsedTime, 0};
+
+    if (game->leftKeyPressed ) record.inputs |= TICK_LEFT;
+    if (game->rightKeyPressed) record.inputs |= TICK_RIGHT;
+
+    if (startPending) {
+        record.inputs |= TICK_START;
+        startTick = nbRecords;
+        startPending = false;
+    }
+
+    records[nbRecords++] = record;
+    currentTick = nbRecords;
+
+    if (currentTick % KEYFRAME_INTERVAL != 0) return;
+
+    if ((size_t) (nbKeyframes + 1) * keyframeSize > TIMELINE_MAX_MEMORY) {
+        printf("Timeline full : the next ticks are not recorded\n");
+        recording = false;
+        return;
+    }
+
+    if (nbKeyframes == keyframesCapacity) {
+        keyframesCapacity *= 2;
+        keyframes = realloc(keyframes, keyframesCapacity * keyframeSize);
+    }
+
+    // The number of bodies doesn't change during a timeline, so neither does the size
+    writeSnapshot(game, keyframes + nbKeyframes * keyframeSize, keyframeSize);
+    nbKeyframes++;
+}
+
+/**
+ * Bring the game to a recorded tick: the nearest keyframe before it is restored, then the recorded ticks are simulated again
+ * 
+ * @param game The game
+ * @param tick Tick to reach (clamped to the recorded ones)
+ * 
+ * @return True if the spaceship was launched at this tick, false otherwise
+*/
+bool seekTimeline(Game * game, int tick) {
+    if (tick < 0) tick = 0;
+    if (tick > nbRecords) tick = nbRecords;
+
+    int keyframe = tick / KEYFRAME_INTERVAL;
+
+    if (keyframe >= nbKeyframes) keyframe = nbKeyframes - 1;
+
+    restoreSnapshot(game, keyframes + keyframe * keyframeSize, keyframeSize);
+
+    for (int i = keyframe * KEYFRAME_INTERVAL; i < tick; i++) {
+        TickRecord record = records[i];
+
+        if (record.inputs & TICK_START) startGame(game);
+
+        game->leftKeyPressed  = record.inputs & TICK_LEFT;
+        game->rightKeyPressed = record.inputs & TICK_RIGHT;
+
+        // The planets only depend on the time
+        game->elapsedTime = record.elapsedTime;
+        rotatePlanets(game);
+
+        moveSpaceship(game);
+    }
+
+    // The keys pressed now are taken into account again on the next events
+    game->leftKeyPressed  = false;
+    game->rightKeyPressed = false;
+
+    currentTick = tick;
+    startPending = false;
+
+    // Forgetting the ticks after this one makes room again
+    recording = true;
+
+    return startTick >= 0 && startTick < tick;
+}
+
+/**
+ * Get the tick reached by the game
+ * 
+ * @return Number of ticks since the start of the timeline
+*/
+int getTimelineTick() {
+    return currentTick;
+}
+
+/**
+ * Get the number of recorded ticks
+ * 
+ * @return Number of ticks
+*/
+int getTimelineLength() {
+    return nbRecords;
+}
+
+/**
+ * Free the recorded timeline
+*/
+void freeTimeline() {
+    free(records);
+    free(keyframes);
+
+    records = NULL;
+    keyframes = NULL;
+
+    recordsCapacity = 0;
+    keyframesCapacity = 0;
+
+    recording = false;
+}
@@ -0,0 +1,12 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+void startTimeline(Game * game);
+void recordGameStart();
+void recordTick(Game * game);
+bool seekTimeline(Game * game, int tick);
+int getTimelineTick();
+int getTimelineLength();
+void freeTimeline();
+
+#endif
\ No newline at end of file
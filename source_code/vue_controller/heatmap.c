@@ -0,0 +1,264 @@
+#include <stdbool.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "../model/model.h"
+#include "../worker_pool/worker_pool.h"
+#include "heatmap.h"
+
+// Size in pixels of a cell of the heatmap (the field is computed once per cell)
+#define HEATMAP_CELL 4
+
+// Size in cells of a tile (the unit of work of the workers)
+#define HEATMAP_TILE 16
+
+// Distance in pixels from a moving body beyond which the field is assumed unchanged
+#define HEATMAP_INFLUENCE 160
+
+// Number of frames between two recomputations of the whole heatmap (for the small changes far from the bodies)
+#define HEATMAP_REFRESH 60
+
+// Strength of the gravity shown with the brightest color
+#define HEATMAP_MAX_STRENGTH 8.0
+
+static SDL_Texture * heatmapTexture;
+static Uint32 * heatmapPixels;
+static int nbCellsX, nbCellsY;
+
+static int nbTilesX, nbTilesY;
+static bool * dirtyTiles;
+static int nbTilesToCompute;
+static int * tilesToCompute;
+static SDL_atomic_t nextTile;
+
+// State of the last computed heatmap
+static Position heatmapCamera;
+static int nbKnownBodies;
+static Position * knownPositions;
+static int framesSinceRefresh;
+
+// Game read by the workers during a computation
+static Game * heatmapGame;
+
+static WorkerPool * heatmapPool;
+
+/**
+ * Convert a strength of the gravity to a color (dark blue for the weak pulls, yellow for the strong ones)
+ * 
+ * @param strength Strength of the gravity
+ * 
+ * @return Color in ARGB8888 format
+*/
+Uint32 getHeatmapColor(Real strength) {
+    // Logarithmic scale, so that the weak pulls are visible too
+    double t = log1p(strength) / log1p(HEATMAP_MAX_STRENGTH);
+    if (t > 1) t = 1;
+
+    Uint32 red   = 160 * fmin(1, 2 * t);
+    Uint32 green = 160 * fmax(0, 2 * t - 1);
+    Uint32 blue  = 96 * (1 - t) * fmin(1, 4 * t);
+
+    return 0xFF000000 | red << 16 | green << 8 | blue;
+}
+
+/**
+ * Compute the cells of a tile
+ * 
+ * @param tile Index of the tile
+*/
+void computeHeatmapTile(int tile) {
+    Real pointsX[HEATMAP_TILE];
+    Real weightedForces[HEATMAP_TILE];
+    Real totalDistances[HEATMAP_TILE];
+    Real strengths[HEATMAP_TILE];
+
+    Configuration configuration = getConfiguration(heatmapGame);
+
+    int firstCellX = tile % nbTilesX * HEATMAP_TILE;
+    int firstCellY = tile / nbTilesX * HEATMAP_TILE;
+
+    int nbColumns = firstCellX + HEATMAP_TILE < nbCellsX ? HEATMAP_TILE : nbCellsX - firstCellX;
+    int nbRows    = firstCellY + HEATMAP_TILE < nbCellsY ? HEATMAP_TILE : nbCellsY - firstCellY;
+
+    // Centers of the cells in the world (inside of it, like the bodies)
+    for (int k = 0; k < nbColumns; k++) {
+        pointsX[k] = fmod(heatmapCamera.posX + (firstCellX + k + 0.5) * HEATMAP_CELL, configuration.worldWidth);
+    }
+
+    for (int row = 0; row < nbRows; row++) {
+        Real pointY = fmod(heatmapCamera.posY + (firstCellY + row + 0.5) * HEATMAP_CELL, configuration.worldHeight);
+
+        getGravityStrengths(heatmapGame, nbColumns, pointsX, pointY, weightedForces, totalDistances, strengths);
+
+        Uint32 * pixels = &heatmapPixels[(firstCellY + row) * nbCellsX + firstCellX];
+
+        for (int k = 0; k < nbColumns; k++) {
+            pixels[k] = getHeatmapColor(strengths[k]);
+        }
+    }
+}
+
+/**
+ * Compute tiles until there is none left
+ * 
+ * @param thread Unused
+ * @param data Unused
+*/
+void computeRemainingHeatmapTiles(int thread, void * data) {
+    int index;
+
+    while ((index = SDL_AtomicAdd(&nextTile, 1)) < nbTilesToCompute) {
+        computeHeatmapTile(tilesToCompute[index]);
+    }
+}
+
+/**
+ * Create the texture of the heatmap and its workers
+ * 
+ * @param renderer Renderer used
+ * @param width Window's width
+ * @param height Window's height
+*/
+void initializeHeatmap(SDL_Renderer * renderer, int width, int height) {
+    nbCellsX = (width  + HEATMAP_CELL - 1) / HEATMAP_CELL;
+    nbCellsY = (height + HEATMAP_CELL - 1) / HEATMAP_CELL;
+
+    heatmapTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, nbCellsX, nbCellsY);
+    if (heatmapTexture == NULL) {
+        SDL_Log("Heatmap texture cannot be generated %s", SDL_GetError());
+        exit(1);
+    }
+
+    heatmapPixels = malloc(nbCellsX * nbCellsY * sizeof(Uint32));
+
+    nbTilesX = (nbCellsX + HEATMAP_TILE - 1) / HEATMAP_TILE;
+    nbTilesY = (nbCellsY + HEATMAP_TILE - 1) / HEATMAP_TILE;
+
+    dirtyTiles = malloc(nbTilesX * nbTilesY * sizeof(bool));
+    tilesToCompute = malloc(nbTilesX * nbTilesY * sizeof(int));
+
+    // Everything is computed on the first frame
+    nbKnownBodies = -1;
+    knownPositions = NULL;
+
+    heatmapPool = createWorkerPool("heatmap");
+}
+
+/**
+ * Mark the tiles around a position of the window as dirty
+ * 
+ * @param x Horizontal coordinate in the window
+ * @param y Vertical coordinate in the window
+ * @param reach Distance in pixels of the affected tiles
+*/
+void markHeatmapTiles(Real x, Real y, Real reach) {
+    int tileSize = HEATMAP_CELL * HEATMAP_TILE;
+
+    int firstX = floor((x - reach) / tileSize);
+    int firstY = floor((y - reach) / tileSize);
+    int lastX  = floor((x + reach) / tileSize);
+    int lastY  = floor((y + reach) / tileSize);
+
+    if (firstX < 0) firstX = 0;
+    if (firstY < 0) firstY = 0;
+    if (lastX >= nbTilesX) lastX = nbTilesX - 1;
+    if (lastY >= nbTilesY) lastY = nbTilesY - 1;
+
+    for (int tileY = firstY; tileY <= lastY; tileY++) {
+        for (int tileX = firstX; tileX <= lastX; tileX++) {
+            dirtyTiles[tileY * nbTilesX + tileX] = true;
+        }
+    }
+}
+
+/**
+ * List the tiles to compute: all of them when the view changed, only those near the moved bodies otherwise
+ * 
+ * @param game Displayed game
+ * @param camera Position in the world of the upper left corner of the window
+*/
+void listDirtyHeatmapTiles(Game * game, Position camera) {
+    Configuration configuration = getConfiguration(game);
+
+    bool everything = nbKnownBodies != configuration.nbStars
+        || camera.posX != heatmapCamera.posX || camera.posY != heatmapCamera.posY
+        || ++framesSinceRefresh >= HEATMAP_REFRESH;
+
+    if (nbKnownBodies != configuration.nbStars) {
+        nbKnownBodies = configuration.nbStars;
+        free(knownPositions);
+        knownPositions = malloc(nbKnownBodies * sizeof(Position));
+    }
+
+    if (everything) framesSinceRefresh = 0;
+
+    memset(dirtyTiles, everything, nbTilesX * nbTilesY * sizeof(bool));
+
+    int index = 0;
+
+    // Iterate through all the bodies (suns first, then planets)
+    for (int i = 0; i < configuration.nbSolarSystems; i++) {
+        SolarSystem solarSystem = configuration.solarSystems[i];
+
+        for (int j = -1; j < solarSystem.nbPlanets; j++) {
+            Position position = j < 0 ? solarSystem.sun.position : solarSystem.planets[j].position;
+            int radius = j < 0 ? solarSystem.sun.radius : solarSystem.planets[j].radius;
+
+            Position known = knownPositions[index];
+
+            // The field changed around the old and the new places of the body
+            if (!everything && (known.posX != position.posX || known.posY != position.posY)) {
+                markHeatmapTiles(known.posX - camera.posX, known.posY - camera.posY, HEATMAP_INFLUENCE + abs(radius));
+                markHeatmapTiles(position.posX - camera.posX, position.posY - camera.posY, HEATMAP_INFLUENCE + abs(radius));
+            }
+
+            knownPositions[index++] = position;
+        }
+    }
+
+    heatmapCamera = camera;
+
+    nbTilesToCompute = 0;
+
+    for (int i = 0; i < nbTilesX * nbTilesY; i++) {
+        if (dirtyTiles[i]) tilesToCompute[nbTilesToCompute++] = i;
+    }
+}
+
+/**
+ * Update the heatmap of the gravity and draw it over the whole window
+ * 
+ * @param renderer Renderer used
+ * @param game Displayed game
+ * @param camera Position in the world of the upper left corner of the window
+*/
+void drawHeatmap(SDL_Renderer * renderer, Game * game, Position camera) {
+    listDirtyHeatmapTiles(game, camera);
+
+    if (nbTilesToCompute > 0) {
+        heatmapGame = game;
+        SDL_AtomicSet(&nextTile, 0);
+
+        runWorkerPool(heatmapPool, getWorkerPoolSize(heatmapPool), computeRemainingHeatmapTiles, NULL);
+
+        SDL_UpdateTexture(heatmapTexture, NULL, heatmapPixels, nbCellsX * sizeof(Uint32));
+    }
+
+    // Upscaling to the size of the window
+    SDL_Rect destination = {0, 0, nbCellsX * HEATMAP_CELL, nbCellsY * HEATMAP_CELL};
+    SDL_RenderCopy(renderer, heatmapTexture, NULL, &destination);
+}
+
+/**
+ * Stop the workers and free the heatmap
+*/
+void freeHeatmap() {
+    freeWorkerPool(heatmapPool);
+
+    free(heatmapPixels);
+    free(dirtyTiles);
+    free(tilesToCompute);
+    free(knownPositions);
+
+    SDL_DestroyTexture(heatmapTexture);
+}
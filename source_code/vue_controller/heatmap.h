@@ -0,0 +1,8 @@
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+void initializeHeatmap(SDL_Renderer * renderer, int width, int height);
+void drawHeatmap(SDL_Renderer * renderer, Game * game, Position camera);
+void freeHeatmap();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,259 @@
+#include <stdbool.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "hud.h"
+
+// Number of recorded frames (about 5 seconds at 60 FPS), one pixel wide each in the sparkline
+#define HUD_HISTORY 288
+
+#define HUD_MARGIN 8
+#define HUD_PADDING 6
+#define HUD_LINE_HEIGHT 12
+#define HUD_NB_LINES 4
+#define HUD_SPARKLINE_HEIGHT 40
+
+#define GLYPH_SIZE 8
+#define FIRST_GLYPH ' '
+#define LAST_GLYPH '~'
+
+// Frame time drawn at the top of the sparkline (in milliseconds)
+#define SPARKLINE_SCALE 50.0
+#define FRAME_BUDGET (1000.0 / 60)
+
+static bool hudShown = false;
+
+static SDL_Texture * glyphAtlas;
+
+// Rolling histories of the frame times and of the phases durations (in milliseconds)
+static double frameTimes[HUD_HISTORY];
+static double phaseTimes[NB_PHASES][HUD_HISTORY];
+static int nbFrames = 0;
+static int lastFrame = HUD_HISTORY - 1;
+
+// Preallocated buffers of the drawing
+static double sortedFrameTimes[HUD_HISTORY];
+static SDL_Rect sparklineBars[HUD_HISTORY];
+
+static char * phaseNames[NB_PHASES] = {"physics", "render", "present"};
+
+/**
+ * Draw once all the printable characters in a texture, so that the text of the HUD is only copied from it
+ * 
+ * @param renderer Renderer of the window
+ * 
+ * @return True if the glyph atlas was created, false otherwise
+*/
+bool initializeHud(SDL_Renderer * renderer) {
+    int nbGlyphs = LAST_GLYPH - FIRST_GLYPH + 1;
+
+    glyphAtlas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, nbGlyphs * GLYPH_SIZE, GLYPH_SIZE);
+
+    if (glyphAtlas == NULL || SDL_SetRenderTarget(renderer, glyphAtlas) != 0) {
+        SDL_Log("HUD glyph atlas cannot be generated %s", SDL_GetError());
+        return false;
+    }
+
+    // Transparent background, white glyphs colored when copied
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    for (int i = 0; i < nbGlyphs; i++) {
+        characterRGBA(renderer, i * GLYPH_SIZE, 0, FIRST_GLYPH + i, 255, 255, 255, 255);
+    }
+
+    SDL_SetRenderTarget(renderer, NULL);
+    SDL_SetTextureBlendMode(glyphAtlas, SDL_BLENDMODE_BLEND);
+
+    return true;
+}
+
+/**
+ * Record the duration of a frame
+ * 
+ * @param milliseconds Time elapsed since the previous frame
+*/
+void recordFrameTime(double milliseconds) {
+    lastFrame = (lastFrame + 1) % HUD_HISTORY;
+
+    frameTimes[lastFrame] = milliseconds;
+
+    for (int phase = 0; phase < NB_PHASES; phase++) {
+        phaseTimes[phase][lastFrame] = 0;
+    }
+
+    if (nbFrames < HUD_HISTORY) nbFrames++;
+}
+
+/**
+ * Record the duration of a phase of the current frame
+ * 
+ * @param phase The phase
+ * @param milliseconds Duration of the phase
+*/
+void recordPhaseTime(FramePhase phase, double milliseconds) {
+    phaseTimes[phase][lastFrame] += milliseconds;
+}
+
+/**
+ * Get the duration of a phase of the last complete frame
+ * 
+ * @param phase The phase
+ * 
+ * @return Duration of the phase in milliseconds
+*/
+double getLastPhaseTime(FramePhase phase) {
+    return phaseTimes[phase][(lastFrame + HUD_HISTORY - 1) % HUD_HISTORY];
+}
+
+/**
+ * Show or hide the HUD
+*/
+void permuteHudShowing() {
+    hudShown = !hudShown;
+}
+
+/**
+ * Tell if the HUD is shown
+ * 
+ * @return True if the HUD is shown, false otherwise
+*/
+bool isHudShown() {
+    return hudShown;
+}
+
+/**
+ * Region of the window covered by the HUD
+ * 
+ * @return The rectangle covered by the HUD
+*/
+SDL_Rect getHudRectangle() {
+    return (SDL_Rect) {
+        HUD_MARGIN,
+        HUD_MARGIN,
+        HUD_HISTORY + 2 * HUD_PADDING,
+        HUD_NB_LINES * HUD_LINE_HEIGHT + HUD_SPARKLINE_HEIGHT + 3 * HUD_PADDING
+    };
+}
+
+/**
+ * Compare two durations (for qsort)
+*/
+int compareDurations(const void * a, const void * b) {
+    double duration1 = *(double *) a;
+    double duration2 = *(double *) b;
+
+    return (duration1 > duration2) - (duration1 < duration2);
+}
+
+/**
+ * Copy a text from the glyph atlas
+ * 
+ * @param renderer Renderer of the window
+ * @param x Abscissa of the text
+ * @param y Ordinate of the text
+ * @param text The text
+*/
+void drawText(SDL_Renderer * renderer, int x, int y, char * text) {
+    for (int i = 0; text[i] != '\0'; i++) {
+        if (text[i] < FIRST_GLYPH || text[i] > LAST_GLYPH) continue;
+
+        SDL_Rect source = {(text[i] - FIRST_GLYPH) * GLYPH_SIZE, 0, GLYPH_SIZE, GLYPH_SIZE};
+        SDL_Rect destination = {x + i * GLYPH_SIZE, y, GLYPH_SIZE, GLYPH_SIZE};
+
+        SDL_RenderCopy(renderer, glyphAtlas, &source, &destination);
+    }
+}
+
+/**
+ * Draw the frame times statistics, the phases durations and the sparkline of the last frames over the window
+ * 
+ * @param renderer Renderer of the window
+ * @param nbBodies Number of suns and planets
+*/
+void drawHud(SDL_Renderer * renderer, int nbBodies) {
+    if (!hudShown || glyphAtlas == NULL) return;
+
+    SDL_Rect panel = getHudRectangle();
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 192);
+    SDL_RenderFillRect(renderer, &panel);
+
+    // Percentiles of the frame times
+    memcpy(sortedFrameTimes, frameTimes, sizeof(frameTimes));
+    qsort(sortedFrameTimes, nbFrames, sizeof(double), compareDurations);
+
+    double p50 = nbFrames > 0 ? sortedFrameTimes[(nbFrames - 1) * 50 / 100] : 0;
+    double p95 = nbFrames > 0 ? sortedFrameTimes[(nbFrames - 1) * 95 / 100] : 0;
+    double p99 = nbFrames > 0 ? sortedFrameTimes[(nbFrames - 1) * 99 / 100] : 0;
+
+    double historyDuration = 0;
+
+    for (int i = 0; i < nbFrames; i++) {
+        historyDuration += frameTimes[i];
+    }
+
+    // Average durations of the phases, the current frame being still in progress
+    double phaseAverages[NB_PHASES] = {0};
+
+    for (int phase = 0; phase < NB_PHASES; phase++) {
+        for (int i = 0; i < nbFrames; i++) {
+            if (i != lastFrame) phaseAverages[phase] += phaseTimes[phase][i];
+        }
+
+        if (nbFrames > 1) phaseAverages[phase] /= nbFrames - 1;
+    }
+
+    char line[64];
+    int x = panel.x + HUD_PADDING;
+    int y = panel.y + HUD_PADDING;
+
+    SDL_SetTextureColorMod(glyphAtlas, 255, 255, 255);
+
+    snprintf(line, sizeof(line), "frame p50 %5.1f p95 %5.1f p99 %5.1f", p50, p95, p99);
+    drawText(renderer, x, y, line);
+
+    snprintf(line, sizeof(line), "%-7s %5.2f ms  %-7s %5.2f ms", phaseNames[PHYSICS_PHASE], phaseAverages[PHYSICS_PHASE], phaseNames[RENDER_PHASE], phaseAverages[RENDER_PHASE]);
+    drawText(renderer, x, y + HUD_LINE_HEIGHT, line);
+
+    snprintf(line, sizeof(line), "%-7s %5.2f ms  bodies  %d", phaseNames[PRESENT_PHASE], phaseAverages[PRESENT_PHASE], nbBodies);
+    drawText(renderer, x, y + 2 * HUD_LINE_HEIGHT, line);
+
+    SDL_SetTextureColorMod(glyphAtlas, 128, 128, 128);
+    snprintf(line, sizeof(line), "last %.1f s, top %.0f ms", historyDuration / 1000, SPARKLINE_SCALE);
+    drawText(renderer, x, y + 3 * HUD_LINE_HEIGHT, line);
+
+    // Sparkline of the frame times, oldest on the left
+    int baseline = y + HUD_NB_LINES * HUD_LINE_HEIGHT + HUD_PADDING + HUD_SPARKLINE_HEIGHT;
+
+    for (int i = 0; i < nbFrames; i++) {
+        double frameTime = frameTimes[(lastFrame - nbFrames + 1 + i + HUD_HISTORY) % HUD_HISTORY];
+        int height = frameTime / SPARKLINE_SCALE * HUD_SPARKLINE_HEIGHT;
+
+        if (height > HUD_SPARKLINE_HEIGHT) height = HUD_SPARKLINE_HEIGHT;
+        if (height < 1) height = 1;
+
+        sparklineBars[i] = (SDL_Rect) {x + HUD_HISTORY - nbFrames + i, baseline - height, 1, height};
+    }
+
+    SDL_SetRenderDrawColor(renderer, 0, 255, 128, 255);
+    SDL_RenderFillRects(renderer, sparklineBars, nbFrames);
+
+    // Frame budget at 60 FPS
+    int budgetY = baseline - FRAME_BUDGET / SPARKLINE_SCALE * HUD_SPARKLINE_HEIGHT;
+
+    SDL_SetRenderDrawColor(renderer, 255, 64, 64, 255);
+    SDL_RenderDrawLine(renderer, x, budgetY, x + HUD_HISTORY - 1, budgetY);
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
+
+/**
+ * Free the glyph atlas
+*/
+void freeHud() {
+    if (glyphAtlas != NULL) SDL_DestroyTexture(glyphAtlas);
+
+    glyphAtlas = NULL;
+}
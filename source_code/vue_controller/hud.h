@@ -0,0 +1,21 @@
+#ifndef HUD_H
+#define HUD_H
+
+typedef enum {
+    PHYSICS_PHASE,
+    RENDER_PHASE,
+    PRESENT_PHASE,
+    NB_PHASES
+} FramePhase;
+
+bool initializeHud(SDL_Renderer * renderer);
+void recordFrameTime(double milliseconds);
+void recordPhaseTime(FramePhase phase, double milliseconds);
+double getLastPhaseTime(FramePhase phase);
+void permuteHudShowing();
+bool isHudShown();
+SDL_Rect getHudRectangle();
+void drawHud(SDL_Renderer * renderer, int nbBodies);
+void freeHud();
+
+#endif
\ No newline at end of file
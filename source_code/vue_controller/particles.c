@@ -0,0 +1,219 @@
+#include <stdbool.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "../model/model.h"
+#include "particles.h"
+
+#define PARTICLES_CAPACITY 131072
+
+// Slowing down of the particles at each tick
+#define PARTICLES_DRAG 0.97f
+
+// Particles of the spaceship's exhaust at each tick while it steers
+#define THRUST_PARTICLES 200
+#define THRUST_SPEED 3.0f
+#define THRUST_LIFETIME 40
+
+#define EXPLOSION_PARTICLES 100000
+#define EXPLOSION_SPEED 8.0f
+#define EXPLOSION_LIFETIME 120
+
+// Live particles in structure of arrays, packed at the beginning of the pool
+static int nbParticles;
+static float * particleX;
+static float * particleY;
+static float * particleVelocityX;
+static float * particleVelocityY;
+static float * particleLife;
+
+// Points of the visible particles, drawn at once
+static SDL_Point * points;
+
+// The particles never change the course of the game, so they have their own generator
+static unsigned int particlesRandomState = 1;
+
+/**
+ * Allocate the pool of particles (never resized)
+*/
+void initializeParticles() {
+    nbParticles = 0;
+
+    particleX         = malloc(PARTICLES_CAPACITY * sizeof(float));
+    particleY         = malloc(PARTICLES_CAPACITY * sizeof(float));
+    particleVelocityX = malloc(PARTICLES_CAPACITY * sizeof(float));
+    particleVelocityY = malloc(PARTICLES_CAPACITY * sizeof(float));
+    particleLife      = malloc(PARTICLES_CAPACITY * sizeof(float));
+
+    points = malloc(PARTICLES_CAPACITY * sizeof(SDL_Point));
+}
+
+/**
+ * Emit particles from a point (the oldest particles being overwritten when the pool is full)
+ * 
+ * @param origin Position in the world of the emission
+ * @param direction Mean velocity of the particles
+ * @param spread Maximal random speed added to each particle
+ * @param count Number of particles
+ * @param lifetime Maximal number of ticks the particles live
+*/
+void emitParticles(Position origin, Vector direction, float spread, int count, int lifetime) {
+    if (count > PARTICLES_CAPACITY) count = PARTICLES_CAPACITY;
+
+    for (int i = 0; i < count; i++) {
+        // Once full, the pool recycles its first slots (the oldest ones are the most likely there)
+        int index = nbParticles < PARTICLES_CAPACITY ? nbParticles++ : i;
+
+        double angle = getRandomNumber(&particlesRandomState) * 2 * M_PI;
+        double speed = getRandomNumber(&particlesRandomState) * spread;
+
+        particleX[index] = origin.posX;
+        particleY[index] = origin.posY;
+        particleVelocityX[index] = direction.vecX + speed * cos(angle);
+        particleVelocityY[index] = direction.vecY + speed * sin(angle);
+        particleLife[index] = (0.5 + 0.5 * getRandomNumber(&particlesRandomState)) * lifetime;
+    }
+}
+
+/**
+ * Emit the exhaust of the spaceship while it steers
+ * 
+ * @param game Displayed game
+*/
+void emitThrustParticles(Game * game) {
+    if (!game->leftKeyPressed && !game->rightKeyPressed) return;
+
+    Spaceship spaceship = getConfiguration(game).spaceship;
+
+    Real speed = getVectorStrength(spaceship.velocity);
+
+    if (speed == 0) return;
+
+    // Backwards, behind the spaceship
+    Vector exhaust = {-THRUST_SPEED * spaceship.velocity.vecX / speed, -THRUST_SPEED * spaceship.velocity.vecY / speed};
+
+    emitParticles(spaceship.position, exhaust, THRUST_SPEED / 2, THRUST_PARTICLES, THRUST_LIFETIME);
+}
+
+/**
+ * Blow the spaceship up
+ * 
+ * @param game Displayed game
+*/
+void emitExplosionParticles(Game * game) {
+    Spaceship spaceship = getConfiguration(game).spaceship;
+
+    emitParticles(spaceship.position, (Vector) {0, 0}, EXPLOSION_SPEED, EXPLOSION_PARTICLES, EXPLOSION_LIFETIME);
+}
+
+/**
+ * Move all the particles by one tick and remove the dead ones
+*/
+void updateParticles() {
+    // Same operations on every particle, without any branch
+    for (int i = 0; i < nbParticles; i++) {
+        particleX[i] += particleVelocityX[i];
+        particleY[i] += particleVelocityY[i];
+
+        particleVelocityX[i] *= PARTICLES_DRAG;
+        particleVelocityY[i] *= PARTICLES_DRAG;
+
+        particleLife[i] -= 1;
+    }
+
+    // Packing of the live particles (the last one takes the place of a dead one)
+    for (int i = 0; i < nbParticles; ) {
+        if (particleLife[i] > 0) {
+            i++;
+            continue;
+        }
+
+        nbParticles--;
+
+        particleX[i] = particleX[nbParticles];
+        particleY[i] = particleY[nbParticles];
+        particleVelocityX[i] = particleVelocityX[nbParticles];
+        particleVelocityY[i] = particleVelocityY[nbParticles];
+        particleLife[i] = particleLife[nbParticles];
+    }
+}
+
+/**
+ * Get the number of live particles
+ * 
+ * @return Number of particles
+*/
+int getParticlesCount() {
+    return nbParticles;
+}
+
+/**
+ * Calculate the rectangle covering all the particles, clipped to the window
+ * 
+ * @param camera Position in the world of the upper left corner of the window
+ * @param width Window's width
+ * @param height Window's height
+ * 
+ * @return Covering rectangle (empty if there is no particle)
+*/
+SDL_Rect getParticlesRectangle(Position camera, int width, int height) {
+    if (nbParticles == 0) return (SDL_Rect) {0, 0, 0, 0};
+
+    float minX = particleX[0], maxX = particleX[0];
+    float minY = particleY[0], maxY = particleY[0];
+
+    for (int i = 1; i < nbParticles; i++) {
+        minX = fminf(minX, particleX[i]);
+        maxX = fmaxf(maxX, particleX[i]);
+        minY = fminf(minY, particleY[i]);
+        maxY = fmaxf(maxY, particleY[i]);
+    }
+
+    SDL_Rect box = {minX - camera.posX - 1, minY - camera.posY - 1, maxX - minX + 3, maxY - minY + 3};
+    SDL_Rect window = {0, 0, width, height};
+    SDL_Rect clipped;
+
+    if (!SDL_IntersectRect(&box, &window, &clipped)) return (SDL_Rect) {0, 0, 0, 0};
+
+    return clipped;
+}
+
+/**
+ * Draw all the visible particles with a single call
+ * 
+ * @param renderer Renderer used
+ * @param camera Position in the world of the upper left corner of the window
+ * @param width Window's width
+ * @param height Window's height
+ * @param hexColor Color of the particles
+*/
+void drawParticles(SDL_Renderer * renderer, Position camera, int width, int height, Uint32 hexColor) {
+    int nbPoints = 0;
+
+    for (int i = 0; i < nbParticles; i++) {
+        int x = particleX[i] - camera.posX;
+        int y = particleY[i] - camera.posY;
+
+        points[nbPoints] = (SDL_Point) {x, y};
+
+        // The slot is kept only for a visible particle
+        nbPoints += x >= 0 && x < width && y >= 0 && y < height;
+    }
+
+    if (nbPoints == 0) return;
+
+    SDL_SetRenderDrawColor(renderer, (hexColor >> 24) & 0xFF, (hexColor >> 16) & 0xFF, (hexColor >> 8) & 0xFF, hexColor & 0xFF);
+    SDL_RenderDrawPoints(renderer, points, nbPoints);
+}
+
+/**
+ * Free the pool of particles
+*/
+void freeParticles() {
+    free(particleX);
+    free(particleY);
+    free(particleVelocityX);
+    free(particleVelocityY);
+    free(particleLife);
+    free(points);
+}
@@ -0,0 +1,14 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+void initializeParticles();
+void emitParticles(Position origin, Vector direction, float spread, int count, int lifetime);
+void emitThrustParticles(Game * game);
+void emitExplosionParticles(Game * game);
+void updateParticles();
+int getParticlesCount();
+SDL_Rect getParticlesRectangle(Position camera, int width, int height);
+void drawParticles(SDL_Renderer * renderer, Position camera, int width, int height, Uint32 hexColor);
+void freeParticles();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,470 @@
+#include <stdbool.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "../worker_pool/worker_pool.h"
+#include "rasterizer.h"
+
+#define TILE_SIZE 64
+
+typedef enum {
+    FILLED_CIRCLE,
+    EMPTY_CIRCLE,
+    FILLED_RECTANGLE,
+    EMPTY_RECTANGLE,
+    LINE
+} PrimitiveType;
+
+typedef struct {
+    PrimitiveType type;
+
+    // Circles use (x1, y1) as center and radius, rectangles and lines use (x1, y1) and (x2, y2) as corners
+    int x1, y1;
+    int x2, y2;
+    int radius;
+
+    Uint32 color;
+} Primitive;
+
+typedef struct {
+    int x, y;
+    int width, height;
+
+    int nbPrimitives;
+    int capacity;
+    int * primitives;
+} Tile;
+
+static SDL_Texture * frameTexture;
+static Uint32 * framebuffer;
+static int frameWidth, frameHeight;
+
+static Uint32 frameClearColor;
+
+static int nbPrimitives;
+static int primitivesCapacity;
+static Primitive * primitives;
+
+static int nbTilesX, nbTilesY;
+static Tile * tiles;
+
+static WorkerPool * rasterizationPool;
+static SDL_atomic_t nextTile;
+
+/**
+ * Fill a horizontal span of the framebuffer
+ * 
+ * @param tile Tile in which the span is clipped
+ * @param y Ordinate of the span
+ * @param xStart First abscissa of the span
+ * @param xEnd Last abscissa of the span (included)
+ * @param color Color in ARGB8888 format
+*/
+void fillSpan(Tile * tile, int y, int xStart, int xEnd, Uint32 color) {
+    if (y < tile->y || y >= tile->y + tile->height) return;
+
+    if (xStart < tile->x) xStart = tile->x;
+    if (xEnd >= tile->x + tile->width) xEnd = tile->x + tile->width - 1;
+
+    Uint32 * pixel = framebuffer + y * frameWidth + xStart;
+
+    for (int x = xStart; x <= xEnd; x++) {
+        *pixel++ = color;
+    }
+}
+
+/**
+ * Rasterize a filled circle in a tile
+ * 
+ * @param tile Tile to fill
+ * @param primitive The circle
+*/
+void rasterizeFilledCircle(Tile * tile, Primitive primitive) {
+    int yStart = primitive.y1 - primitive.radius;
+    int yEnd   = primitive.y1 + primitive.radius;
+
+    if (yStart < tile->y) yStart = tile->y;
+    if (yEnd >= tile->y + tile->height) yEnd = tile->y + tile->height - 1;
+
+    int squaredRadius = primitive.radius * primitive.radius;
+
+    // One span per row, its half-width given by the circle equation
+    for (int y = yStart; y <= yEnd; y++) {
+        int dY = y - primitive.y1;
+        int halfWidth = (int) sqrt(squaredRadius - dY * dY);
+
+        fillSpan(tile, y, primitive.x1 - halfWidth, primitive.x1 + halfWidth, primitive.color);
+    }
+}
+
+/**
+ * Rasterize an empty circle (one pixel thick) in a tile
+ * 
+ * @param tile Tile to fill
+ * @param primitive The circle
+*/
+void rasterizeEmptyCircle(Tile * tile, Primitive primitive) {
+    int yStart = primitive.y1 - primitive.radius;
+    int yEnd   = primitive.y1 + primitive.radius;
+
+    if (yStart < tile->y) yStart = tile->y;
+    if (yEnd >= tile->y + tile->height) yEnd = tile->y + tile->height - 1;
+
+    double outerRadius = primitive.radius + 0.5;
+    double innerRadius = primitive.radius - 0.5;
+
+    // The pixels of a row between the inner and outer circles form two spans
+    for (int y = yStart; y <= yEnd; y++) {
+        int dY = y - primitive.y1;
+
+        double outerSquared = outerRadius * outerRadius - dY * dY;
+        double innerSquared = innerRadius * innerRadius - dY * dY;
+
+        int outer = (int) sqrt(outerSquared);
+        int inner = innerSquared > 0 ? (int) ceil(sqrt(innerSquared)) : 0;
+
+        if (inner > outer) inner = outer;
+
+        fillSpan(tile, y, primitive.x1 - outer, primitive.x1 - inner, primitive.color);
+        fillSpan(tile, y, primitive.x1 + inner, primitive.x1 + outer, primitive.color);
+    }
+}
+
+/**
+ * Rasterize a filled rectangle in a tile
+ * 
+ * @param tile Tile to fill
+ * @param primitive The rectangle
+*/
+void rasterizeFilledRectangle(Tile * tile, Primitive primitive) {
+    int yStart = primitive.y1 < tile->y ? tile->y : primitive.y1;
+    int yEnd   = primitive.y2 >= tile->y + tile->height ? tile->y + tile->height - 1 : primitive.y2;
+
+    for (int y = yStart; y <= yEnd; y++) {
+        fillSpan(tile, y, primitive.x1, primitive.x2, primitive.color);
+    }
+}
+
+/**
+ * Rasterize an empty rectangle in a tile
+ * 
+ * @param tile Tile to fill
+ * @param primitive The rectangle
+*/
+void rasterizeEmptyRectangle(Tile * tile, Primitive primitive) {
+    fillSpan(tile, primitive.y1, primitive.x1, primitive.x2, primitive.color);
+    fillSpan(tile, primitive.y2, primitive.x1, primitive.x2, primitive.color);
+
+    // Only the rows of the sides crossing the tile
+    int yStart = primitive.y1 + 1 < tile->y ? tile->y : primitive.y1 + 1;
+    int yEnd   = primitive.y2 > tile->y + tile->height ? tile->y + tile->height : primitive.y2;
+
+    for (int y = yStart; y < yEnd; y++) {
+        fillSpan(tile, y, primitive.x1, primitive.x1, primitive.color);
+        fillSpan(tile, y, primitive.x2, primitive.x2, primitive.color);
+    }
+}
+
+/**
+ * Rasterize a line in a tile
+ * 
+ * Every pixel is computed from the line's equation (not incrementally) so that the
+ * parts of a line drawn by different tiles join exactly
+ * 
+ * @param tile Tile to fill
+ * @param primitive The line
+*/
+void rasterizeLine(Tile * tile, Primitive primitive) {
+    int dX = primitive.x2 - primitive.x1;
+    int dY = primitive.y2 - primitive.y1;
+
+    if (dX == 0 && dY == 0) {
+        fillSpan(tile, primitive.y1, primitive.x1, primitive.x1, primitive.color);
+        return;
+    }
+
+    if (abs(dX) >= abs(dY)) {
+        // Horizontal-ish line: one pixel per column
+        int xStart = dX > 0 ? primitive.x1 : primitive.x2;
+        int xEnd   = dX > 0 ? primitive.x2 : primitive.x1;
+
+        if (xStart < tile->x) xStart = tile->x;
+        if (xEnd >= tile->x + tile->width) xEnd = tile->x + tile->width - 1;
+
+        for (int x = xStart; x <= xEnd; x++) {
+            int y = primitive.y1 + (int) lround((double) (x - primitive.x1) * dY / dX);
+            fillSpan(tile, y, x, x, primitive.color);
+        }
+    } else {
+        // Vertical-ish line: one pixel per row
+        int yStart = dY > 0 ? primitive.y1 : primitive.y2;
+        int yEnd   = dY > 0 ? primitive.y2 : primitive.y1;
+
+        if (yStart < tile->y) yStart = tile->y;
+        if (yEnd >= tile->y + tile->height) yEnd = tile->y + tile->height - 1;
+
+        for (int y = yStart; y <= yEnd; y++) {
+            int x = primitive.x1 + (int) lround((double) (y - primitive.y1) * dX / dY);
+            fillSpan(tile, y, x, x, primitive.color);
+        }
+    }
+}
+
+/**
+ * Clear a tile and rasterize all the primitives binned into it, in submission order
+ * 
+ * @param tile Tile to fill
+*/
+void rasterizeTile(Tile * tile) {
+    for (int y = tile->y; y < tile->y + tile->height; y++) {
+        fillSpan(tile, y, tile->x, tile->x + tile->width - 1, frameClearColor);
+    }
+
+    for (int i = 0; i < tile->nbPrimitives; i++) {
+        Primitive primitive = primitives[tile->primitives[i]];
+
+        switch (primitive.type) {
+            case FILLED_CIRCLE    : rasterizeFilledCircle   (tile, primitive); break;
+            case EMPTY_CIRCLE     : rasterizeEmptyCircle    (tile, primitive); break;
+            case FILLED_RECTANGLE : rasterizeFilledRectangle(tile, primitive); break;
+            case EMPTY_RECTANGLE  : rasterizeEmptyRectangle (tile, primitive); break;
+            case LINE             : rasterizeLine           (tile, primitive); break;
+        }
+    }
+}
+
+/**
+ * Rasterize tiles until there is none left in the frame
+ * 
+ * @param thread Unused
+ * @param data Unused
+*/
+void rasterizeRemainingTiles(int thread, void * data) {
+    int nbTiles = nbTilesX * nbTilesY;
+    int index;
+
+    while ((index = SDL_AtomicAdd(&nextTile, 1)) < nbTiles) {
+        rasterizeTile(&tiles[index]);
+    }
+}
+
+/**
+ * Create the framebuffer, the tiles and the rasterization workers
+ * 
+ * @param renderer Renderer receiving the finished frames
+ * @param width Framebuffer's width
+ * @param height Framebuffer's height
+*/
+void initializeRasterizer(SDL_Renderer * renderer, int width, int height) {
+    frameWidth  = width;
+    frameHeight = height;
+
+    frameTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (frameTexture == NULL) {
+        SDL_Log("Rasterizer texture cannot be generated %s", SDL_GetError());
+        exit(1);
+    }
+
+    framebuffer = malloc(width * height * sizeof(Uint32));
+
+    nbPrimitives = 0;
+    primitivesCapacity = 64;
+    primitives = malloc(primitivesCapacity * sizeof(Primitive));
+
+    // Division of the frame in tiles (the last ones can be smaller)
+    nbTilesX = (width  + TILE_SIZE - 1) / TILE_SIZE;
+    nbTilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+    tiles = malloc(nbTilesX * nbTilesY * sizeof(Tile));
+
+    for (int i = 0; i < nbTilesY; i++) {
+        for (int j = 0; j < nbTilesX; j++) {
+            Tile * tile = &tiles[i * nbTilesX + j];
+
+            tile->x = j * TILE_SIZE;
+            tile->y = i * TILE_SIZE;
+            tile->width  = (j == nbTilesX - 1) ? width  - tile->x : TILE_SIZE;
+            tile->height = (i == nbTilesY - 1) ? height - tile->y : TILE_SIZE;
+
+            tile->nbPrimitives = 0;
+            tile->capacity = 16;
+            tile->primitives = malloc(tile->capacity * sizeof(int));
+        }
+    }
+
+    rasterizationPool = createWorkerPool("rasterizer");
+}
+
+/**
+ * Start a new frame
+ * 
+ * @param clearColor Background color in ARGB8888 format
+*/
+void beginRasterFrame(Uint32 clearColor) {
+    frameClearColor = clearColor;
+    nbPrimitives = 0;
+
+    for (int i = 0; i < nbTilesX * nbTilesY; i++) {
+        tiles[i].nbPrimitives = 0;
+    }
+}
+
+/**
+ * Add a primitive to the frame and bin it into the tiles covered by its bounding box
+ * 
+ * @param primitive The primitive
+ * @param minX Left of the bounding box
+ * @param minY Top of the bounding box
+ * @param maxX Right of the bounding box (included)
+ * @param maxY Bottom of the bounding box (included)
+*/
+void addPrimitive(Primitive primitive, int minX, int minY, int maxX, int maxY) {
+    // Ignoring the primitives outside of the frame
+    if (maxX < 0 || maxY < 0 || minX >= frameWidth || minY >= frameHeight) return;
+
+    if (nbPrimitives == primitivesCapacity) {
+        primitivesCapacity *= 2;
+        primitives = realloc(primitives, primitivesCapacity * sizeof(Primitive));
+    }
+
+    int index = nbPrimitives++;
+    primitives[index] = primitive;
+
+    int firstTileX = minX < 0 ? 0 : minX / TILE_SIZE;
+    int firstTileY = minY < 0 ? 0 : minY / TILE_SIZE;
+    int lastTileX  = maxX >= frameWidth  ? nbTilesX - 1 : maxX / TILE_SIZE;
+    int lastTileY  = maxY >= frameHeight ? nbTilesY - 1 : maxY / TILE_SIZE;
+
+    for (int i = firstTileY; i <= lastTileY; i++) {
+        for (int j = firstTileX; j <= lastTileX; j++) {
+            Tile * tile = &tiles[i * nbTilesX + j];
+
+            // An empty circle does not touch the tiles lying entirely inside of it
+            if (primitive.type == EMPTY_CIRCLE) {
+                double farX = fmax(fabs(tile->x - primitive.x1), fabs(tile->x + tile->width  - primitive.x1));
+                double farY = fmax(fabs(tile->y - primitive.y1), fabs(tile->y + tile->height - primitive.y1));
+
+                if (farX * farX + farY * farY < (primitive.radius - 1) * (primitive.radius - 1)) continue;
+            }
+
+            // Nor does an empty rectangle touch the tiles lying entirely inside of it
+            if (primitive.type == EMPTY_RECTANGLE) {
+                bool insideX = tile->x > primitive.x1 && tile->x + tile->width  - 1 < primitive.x2;
+                bool insideY = tile->y > primitive.y1 && tile->y + tile->height - 1 < primitive.y2;
+
+                if (insideX && insideY) continue;
+            }
+
+            if (tile->nbPrimitives == tile->capacity) {
+                tile->capacity *= 2;
+                tile->primitives = realloc(tile->primitives, tile->capacity * sizeof(int));
+            }
+
+            tile->primitives[tile->nbPrimitives++] = index;
+        }
+    }
+}
+
+/**
+ * Add a filled circle to the frame
+ * 
+ * @param centerX Abscissa of the center
+ * @param centerY Ordinate of the center
+ * @param radius Circle's radius
+ * @param color Color in ARGB8888 format
+*/
+void rasterFilledCircle(int centerX, int centerY, int radius, Uint32 color) {
+    Primitive primitive = {FILLED_CIRCLE, centerX, centerY, 0, 0, radius, color};
+    addPrimitive(primitive, centerX - radius, centerY - radius, centerX + radius, centerY + radius);
+}
+
+/**
+ * Add an empty circle to the frame
+ * 
+ * @param centerX Abscissa of the center
+ * @param centerY Ordinate of the center
+ * @param radius Circle's radius
+ * @param color Color in ARGB8888 format
+*/
+void rasterEmptyCircle(int centerX, int centerY, int radius, Uint32 color) {
+    Primitive primitive = {EMPTY_CIRCLE, centerX, centerY, 0, 0, radius, color};
+    addPrimitive(primitive, centerX - radius - 1, centerY - radius - 1, centerX + radius + 1, centerY + radius + 1);
+}
+
+/**
+ * Add a filled rectangle to the frame
+ * 
+ * @param x Upper left rectangle's corner abscissa
+ * @param y Upper left rectangle's corner ordinate
+ * @param width Rectangle's width
+ * @param height Rectangle's height
+ * @param color Color in ARGB8888 format
+*/
+void rasterFilledRectangle(int x, int y, int width, int height, Uint32 color) {
+    if (width <= 0 || height <= 0) return;
+
+    Primitive primitive = {FILLED_RECTANGLE, x, y, x + width - 1, y + height - 1, 0, color};
+    addPrimitive(primitive, x, y, x + width - 1, y + height - 1);
+}
+
+/**
+ * Add an empty rectangle to the frame
+ * 
+ * @param x Upper left rectangle's corner abscissa
+ * @param y Upper left rectangle's corner ordinate
+ * @param width Rectangle's width
+ * @param height Rectangle's height
+ * @param color Color in ARGB8888 format
+*/
+void rasterEmptyRectangle(int x, int y, int width, int height, Uint32 color) {
+    if (width <= 0 || height <= 0) return;
+
+    Primitive primitive = {EMPTY_RECTANGLE, x, y, x + width - 1, y + height - 1, 0, color};
+    addPrimitive(primitive, x, y, x + width - 1, y + height - 1);
+}
+
+/**
+ * Add a line to the frame
+ * 
+ * @param x1 Abscissa of the first end
+ * @param y1 Ordinate of the first end
+ * @param x2 Abscissa of the second end
+ * @param y2 Ordinate of the second end
+ * @param color Color in ARGB8888 format
+*/
+void rasterLine(int x1, int y1, int x2, int y2, Uint32 color) {
+    Primitive primitive = {LINE, x1, y1, x2, y2, 0, color};
+    addPrimitive(primitive, x1 < x2 ? x1 : x2, y1 < y2 ? y1 : y2, x1 > x2 ? x1 : x2, y1 > y2 ? y1 : y2);
+}
+
+/**
+ * Rasterize all the tiles of the frame in parallel and copy the result to the renderer
+ * 
+ * @param renderer Renderer receiving the frame
+*/
+void endRasterFrame(SDL_Renderer * renderer) {
+    SDL_AtomicSet(&nextTile, 0);
+
+    runWorkerPool(rasterizationPool, getWorkerPoolSize(rasterizationPool), rasterizeRemainingTiles, NULL);
+
+    // The whole frame is uploaded at once
+    SDL_UpdateTexture(frameTexture, NULL, framebuffer, frameWidth * sizeof(Uint32));
+    SDL_RenderCopy(renderer, frameTexture, NULL, NULL);
+}
+
+/**
+ * Stop the workers and free the rasterizer's memories
+*/
+void freeRasterizer() {
+    freeWorkerPool(rasterizationPool);
+
+    for (int i = 0; i < nbTilesX * nbTilesY; i++) {
+        free(tiles[i].primitives);
+    }
+
+    free(tiles);
+    free(primitives);
+    free(framebuffer);
+
+    SDL_DestroyTexture(frameTexture);
+}
@@ -0,0 +1,14 @@
+#ifndef RASTERIZER_H
+#define RASTERIZER_H
+
+void initializeRasterizer(SDL_Renderer * renderer, int width, int height);
+void beginRasterFrame(Uint32 clearColor);
+void rasterFilledCircle(int centerX, int centerY, int radius, Uint32 color);
+void rasterEmptyCircle(int centerX, int centerY, int radius, Uint32 color);
+void rasterFilledRectangle(int x, int y, int width, int height, Uint32 color);
+void rasterEmptyRectangle(int x, int y, int width, int height, Uint32 color);
+void rasterLine(int x1, int y1, int x2, int y2, Uint32 color);
+void endRasterFrame(SDL_Renderer * renderer);
+void freeRasterizer();
+
+#endif
\ No newline at end of file
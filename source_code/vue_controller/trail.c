@@ -0,0 +1,160 @@
+#include <stdbool.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "../model/model.h"
+#include "trail.h"
+
+// Half of the width of the trail (in pixels)
+#define TRAIL_HALF_WIDTH 1.0f
+
+// Positions of the spaceship, written by moveSpaceship()
+static Trail trail;
+
+// Quads of the segments, drawn at once (a segment crossing an edge of the world gives two of them)
+static int nbQuads;
+static SDL_Vertex * vertices;
+static int * indices;
+
+/**
+ * Allocate the trail of the spaceship (never resized) and attach it to a game
+ * 
+ * @param game The game, whose ticks fill the trail
+ * @param length Number of positions kept (at most TRAIL_MAX_LENGTH)
+*/
+void initializeTrail(Game * game, int length) {
+    trail.capacity = length;
+    trail.positions = malloc(length * sizeof(Position));
+
+    clearTrail(&trail);
+
+    vertices = malloc(2 * length * 4 * sizeof(SDL_Vertex));
+    indices  = malloc(2 * length * 6 * sizeof(int));
+
+    // The two triangles of each quad never change
+    for (int i = 0; i < 2 * length; i++) {
+        indices[6 * i    ] = 4 * i;
+        indices[6 * i + 1] = 4 * i + 1;
+        indices[6 * i + 2] = 4 * i + 2;
+        indices[6 * i + 3] = 4 * i + 2;
+        indices[6 * i + 4] = 4 * i + 1;
+        indices[6 * i + 5] = 4 * i + 3;
+    }
+
+    game->trail = &trail;
+}
+
+/**
+ * Add the quad of a segment, unless it is out of the window
+ * 
+ * @param x1 Horizontal coordinate of the start on the screen
+ * @param y1 Vertical coordinate of the start on the screen
+ * @param x2 Horizontal coordinate of the end on the screen
+ * @param y2 Vertical coordinate of the end on the screen
+ * @param color1 Color of the start
+ * @param color2 Color of the end
+ * @param width Window's width
+ * @param height Window's height
+*/
+void addTrailQuad(float x1, float y1, float x2, float y2, SDL_Color color1, SDL_Color color2, int width, int height) {
+    float margin = TRAIL_HALF_WIDTH;
+
+    if ((x1 < -margin && x2 < -margin) || (x1 > width + margin && x2 > width + margin)) return;
+    if ((y1 < -margin && y2 < -margin) || (y1 > height + margin && y2 > height + margin)) return;
+
+    float length = sqrtf((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
+
+    if (length == 0) return;
+
+    // Sides of the segment
+    float normalX = (y1 - y2) / length * TRAIL_HALF_WIDTH;
+    float normalY = (x2 - x1) / length * TRAIL_HALF_WIDTH;
+
+    SDL_Vertex * quad = &vertices[4 * nbQuads++];
+
+    quad[0] = (SDL_Vertex) {{x1 + normalX, y1 + normalY}, color1, {0, 0}};
+    quad[1] = (SDL_Vertex) {{x1 - normalX, y1 - normalY}, color1, {0, 0}};
+    quad[2] = (SDL_Vertex) {{x2 + normalX, y2 + normalY}, color2, {0, 0}};
+    quad[3] = (SDL_Vertex) {{x2 - normalX, y2 - normalY}, color2, {0, 0}};
+}
+
+/**
+ * Draw the trail with a single call, fading out towards its oldest positions
+ * 
+ * @param renderer Renderer used
+ * @param game Displayed game
+ * @param camera Position in the world of the upper left corner of the window
+ * @param width Window's width
+ * @param height Window's height
+ * @param hexColor Color of the newest part of the trail
+*/
+void drawTrail(SDL_Renderer * renderer, Game * game, Position camera, int width, int height, Uint32 hexColor) {
+    if (trail.nbPositions < 2) return;
+
+    Configuration configuration = getConfiguration(game);
+
+    float worldWidth  = configuration.worldWidth;
+    float worldHeight = configuration.worldHeight;
+
+    SDL_Color color = {(hexColor >> 24) & 0xFF, (hexColor >> 16) & 0xFF, (hexColor >> 8) & 0xFF, hexColor & 0xFF};
+    float fading = (float) color.a / (trail.nbPositions - 1);
+
+    nbQuads = 0;
+
+    // From the oldest position to the newest one
+    int index = trail.next - trail.nbPositions;
+    if (index < 0) index += trail.capacity;
+
+    Position start = trail.positions[index];
+    SDL_Color startColor = color;
+    startColor.a = 0;
+
+    for (int i = 1; i < trail.nbPositions; i++) {
+        index = index + 1 < trail.capacity ? index + 1 : 0;
+
+        Position end = trail.positions[index];
+        SDL_Color endColor = color;
+        endColor.a = fading * i;
+
+        // The shortest way, through an edge of the world if the spaceship crossed it
+        float dX = end.posX - start.posX;
+        float dY = end.posY - start.posY;
+
+        bool wrapped = false;
+
+        if (dX >  worldWidth  / 2) { dX -= worldWidth;  wrapped = true; }
+        if (dX < -worldWidth  / 2) { dX += worldWidth;  wrapped = true; }
+        if (dY >  worldHeight / 2) { dY -= worldHeight; wrapped = true; }
+        if (dY < -worldHeight / 2) { dY += worldHeight; wrapped = true; }
+
+        float startX = start.posX - camera.posX;
+        float startY = start.posY - camera.posY;
+        float endX = end.posX - camera.posX;
+        float endY = end.posY - camera.posY;
+
+        // A segment crossing an edge leaves the world on one side and comes back on the other
+        addTrailQuad(startX, startY, startX + dX, startY + dY, startColor, endColor, width, height);
+
+        if (wrapped) {
+            addTrailQuad(endX - dX, endY - dY, endX, endY, startColor, endColor, width, height);
+        }
+
+        start = end;
+        startColor = endColor;
+    }
+
+    if (nbQuads == 0) return;
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometry(renderer, NULL, vertices, 4 * nbQuads, indices, 6 * nbQuads);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
+
+/**
+ * Free the trail
+*/
+void freeTrail() {
+    free(trail.positions);
+    free(vertices);
+    free(indices);
+}
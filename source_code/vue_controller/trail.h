@@ -0,0 +1,11 @@
+#ifndef TRAIL_H
+#define TRAIL_H
+
+// Largest number of positions of the trail
+#define TRAIL_MAX_LENGTH 10000
+
+void initializeTrail(Game * game, int length);
+void drawTrail(SDL_Renderer * renderer, Game * game, Position camera, int width, int height, Uint32 hexColor);
+void freeTrail();
+
+#endif
\ No newline at end of file
@@ -2,14 +2,22 @@
 
 #include <SDL2/SDL2_gfxPrimitives.h>
 
-#include "vue_controller.h"
 #include "../model/model.h"
+#include "vue_controller.h"
+#include "rasterizer.h"
+#include "hud.h"
+#include "particles.h"
+#include "heatmap.h"
+#include "trail.h"
 
 #define OUTER_BORDER_EDGE   10
 #define STARTSHIP_SIZE      10
 #define STARTING_POINT_SIZE 10
 #define ARRIVAL_POINT_SIZE  10
 
+// Number of segments of the drawn elliptical orbits
+#define ORBIT_SEGMENTS 64
+
 #define OUTER_BORDER_COLOR   0xFFFFFFFF
 #define STARTING_POINT_COLOR 0xFFFFFFFF
 #define ARRIVAL_POINT_COLOR  0xFFFFFFFF
@@ -19,11 +27,46 @@
 #define ORBITS_COLOR         0xFFFFFFFF
 #define TRAJECTORY_COLOR     0xFFFFFFFF
 #define GRAVITY_COLOR        0xFF8080FF
+#define PARTICLES_COLOR      0xFFA040FF
+#define TRAIL_COLOR          0xFF6060C0
 
 SDL_Window * window;
 SDL_Renderer * renderer;
 
 bool showTrajectories = false;
+bool showOrbits = true;
+bool showHeatmap = false;
+
+// Position in the world of the upper left corner of the window
+Position camera = {0, 0};
+
+// Dirty rectangles mode (only the regions of the moving objects are repainted)
+bool dirtyRectanglesMode = false;
+bool backgroundCached = false;
+
+SDL_Surface * windowSurface;
+SDL_Surface * backgroundSurface;
+
+// Tiled raster mode (frames drawn by the internal multithreaded rasterizer)
+bool tiledRasterMode = false;
+
+// Ratio between the resolution of the drawn frames and the window's one, the smaller frames being upscaled when presented
+float renderScale = 1;
+SDL_Texture * sceneTexture = NULL;
+
+// Number of positions of the spaceship's trail (0 for none)
+int trailLength = 600;
+
+int nbMovingObjects;
+SDL_Rect * previousRects;
+SDL_Rect * currentRects;
+SDL_Rect * dirtyRects;
+
+// The region of the HUD must be repainted once more after hiding it
+bool hudWasShown = false;
+
+// Region of the particles in the previous frame
+SDL_Rect previousParticlesRect = {0, 0, 0, 0};
 
 /**
  * Calculate the R, G, B and A attributes of a hexadecimal color
@@ -43,6 +86,17 @@ int * convertHexToRGBA(Uint32 hexColor) {
     return tab; 
 }
 
+/**
+ * Convert R, G, B and A attributes into a pixel of the rasterizer's format
+ * 
+ * @param rgbaColor Array of int representing the R, G, B and A attributes
+ * 
+ * @return Color in ARGB8888 format
+*/
+Uint32 convertRGBAToPixel(int * rgbaColor) {
+    return ((Uint32) rgbaColor[3] << 24) | ((Uint32) rgbaColor[0] << 16) | ((Uint32) rgbaColor[1] << 8) | (Uint32) rgbaColor[2];
+}
+
 /**
  * Draw a empty rectangle
  * 
@@ -55,6 +109,12 @@ int * convertHexToRGBA(Uint32 hexColor) {
 void drawEmptyRectangle(int x, int y, int width, int height, Uint32 hexColor) {
     int * rgbaColor = convertHexToRGBA(hexColor);
 
+    if (tiledRasterMode) {
+        rasterEmptyRectangle(x, y, width, height, convertRGBAToPixel(rgbaColor));
+        free(rgbaColor);
+        return;
+    }
+
     SDL_SetRenderDrawColor(renderer, rgbaColor[0], rgbaColor[1], rgbaColor[2], rgbaColor[3]);
 
     free(rgbaColor);
@@ -73,6 +133,12 @@ void drawEmptyRectangle(int x, int y, int width, int height, Uint32 hexColor) {
 void drawCenteredFilledSquare(Position centerPosition, int size, Uint32 hexColor) {
     int * rgbaColor = convertHexToRGBA(hexColor);
 
+    if (tiledRasterMode) {
+        rasterFilledRectangle(centerPosition.posX - size / 2, centerPosition.posY - size / 2, size, size, convertRGBAToPixel(rgbaColor));
+        free(rgbaColor);
+        return;
+    }
+
     SDL_SetRenderDrawColor(renderer, rgbaColor[0], rgbaColor[1], rgbaColor[2], rgbaColor[3]);
 
     free(rgbaColor);
@@ -91,6 +157,12 @@ void drawCenteredFilledSquare(Position centerPosition, int size, Uint32 hexColor
 void drawCenteredEmptySquare(Position centerPosition, int size, Uint32 hexColor) {
     int * rgbaColor = convertHexToRGBA(hexColor);
 
+    if (tiledRasterMode) {
+        rasterEmptyRectangle(centerPosition.posX - size / 2, centerPosition.posY - size / 2, size, size, convertRGBAToPixel(rgbaColor));
+        free(rgbaColor);
+        return;
+    }
+
     SDL_SetRenderDrawColor(renderer, rgbaColor[0], rgbaColor[1], rgbaColor[2], rgbaColor[3]);
 
     free(rgbaColor);
@@ -109,6 +181,12 @@ void drawCenteredEmptySquare(Position centerPosition, int size, Uint32 hexColor)
 void drawEmptyCircle(Position centerPosition, int radius, Uint32 hexColor) {
     int * rgbaColor = convertHexToRGBA(hexColor);
 
+    if (tiledRasterMode) {
+        rasterEmptyCircle(centerPosition.posX, centerPosition.posY, radius, convertRGBAToPixel(rgbaColor));
+        free(rgbaColor);
+        return;
+    }
+
     circleRGBA(renderer, centerPosition.posX, centerPosition.posY, radius, rgbaColor[0], rgbaColor[1], rgbaColor[2], rgbaColor[3]);
 
     free(rgbaColor);
@@ -121,6 +199,14 @@ void drawEmptyCircle(Position centerPosition, int radius, Uint32 hexColor) {
  * @param hexColor Circle's color in hexadecimal format
 */
 void drawFilledCircle(Position centerPosition, int radius, Uint32 hexColor) {
+    if (tiledRasterMode) {
+        // SDL2_gfx reads the color's bytes in memory order (R first on little endian)
+        int rgbaColor[4] = {hexColor & 0xFF, (hexColor >> 8) & 0xFF, (hexColor >> 16) & 0xFF, (hexColor >> 24) & 0xFF};
+
+        rasterFilledCircle(centerPosition.posX, centerPosition.posY, radius, convertRGBAToPixel(rgbaColor));
+        return;
+    }
+
     filledCircleColor(renderer, centerPosition.posX, centerPosition.posY, radius, hexColor);
 }
 
@@ -128,110 +214,716 @@ void drawFilledCircle(Position centerPosition, int radius, Uint32 hexColor) {
  * Draw a vector
  * 
  * @param startingPosition Coordinates of the starting point of the vector
- * @param vector Vector's angle and length
+ * @param vector Vector's cartesian components
  * @param hexColor Vector's color in hexadecimal format
 */
 void drawVector(Position startPosition, Vector vector, Uint32 hexColor) {
     int * rgbaColor = convertHexToRGBA(hexColor);
 
+    if (tiledRasterMode) {
+        rasterLine(startPosition.posX, startPosition.posY, startPosition.posX + 10 * vector.vecX, startPosition.posY + 10 * vector.vecY, convertRGBAToPixel(rgbaColor));
+        free(rgbaColor);
+        return;
+    }
+
     SDL_SetRenderDrawColor(renderer, rgbaColor[0], rgbaColor[1], rgbaColor[2], rgbaColor[3]);
 
     free(rgbaColor);
 
-    SDL_RenderDrawLine(renderer, startPosition.posX, startPosition.posY, startPosition.posX + 10 * vector.strength * cos(vector.angle), startPosition.posY + 10 * vector.strength * sin(vector.angle));
+    SDL_RenderDrawLine(renderer, startPosition.posX, startPosition.posY, startPosition.posX + 10 * vector.vecX, startPosition.posY + 10 * vector.vecY);
 }
 
 /**
- * Initialize all the prerequisites for visual management
+ * Start SDL and create the window, still hidden (it doesn't need the configuration, so it can be done while it is parsed)
 */
-void initializeRenderer() {
-    Configuration configuration = getConfiguration();
-
+void initializeWindow() {
     if (SDL_Init(SDL_INIT_EVERYTHING) < 0) {
         SDL_Log("SDL cant start %s", SDL_GetError());
         exit(1);
     }
 
-    window = SDL_CreateWindow("SDL example", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, configuration.winWidth, configuration.winHeight, SDL_WINDOW_SHOWN);
+    window = SDL_CreateWindow("SDL example", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 640, 480, SDL_WINDOW_HIDDEN);
     if (window == NULL) {
         SDL_Log("Window cant be generated %s", SDL_GetError());
         exit(1);
     }
+}
+
+/**
+ * Initialize all the prerequisites for visual management
+ * 
+ * @param game Game to display
+*/
+void initializeRenderer(Game * game) {
+    Configuration configuration = getConfiguration(game);
+
+    if (window == NULL) {
+        initializeWindow();
+    }
+
+    // The window gets the size of the configuration before being shown
+    SDL_SetWindowSize(window, configuration.winWidth, configuration.winHeight);
+    SDL_SetWindowPosition(window, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED);
+    SDL_ShowWindow(window);
+
+    // With a moving camera, everything moves on the screen
+    if (dirtyRectanglesMode && (configuration.worldWidth > configuration.winWidth || configuration.worldHeight > configuration.winHeight)) {
+        printf("The dirty rectangles mode needs a world the size of the window\n");
+        dirtyRectanglesMode = false;
+    }
+
+    if (dirtyRectanglesMode) {
+        // The dirty rectangles are repainted through the window surface, not the rasterizer
+        tiledRasterMode = false;
+
+        // Drawing directly into the window surface allows to update only some of its regions
+        windowSurface = SDL_GetWindowSurface(window);
+        if (windowSurface == NULL) {
+            SDL_Log("Window surface cannot be obtained %s", SDL_GetError());
+            exit(1);
+        }
+
+        renderer = SDL_CreateSoftwareRenderer(windowSurface);
+    } else {
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    }
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
     if (renderer == NULL) {
         SDL_Log("Renderer cannot be generated %s", SDL_GetError());
         exit(1);
     }
+
+    // The window surface of the dirty rectangles mode can't be resized
+    if (!dirtyRectanglesMode) {
+        // Drawing in the coordinates of the configuration, whatever the size of the window (with black bars to keep the proportions)
+        SDL_RenderSetLogicalSize(renderer, configuration.winWidth, configuration.winHeight);
+        SDL_SetWindowResizable(window, SDL_TRUE);
+    }
+
+    if (renderScale != 1 && (dirtyRectanglesMode || tiledRasterMode)) {
+        printf("The render scale is ignored with --dirty-rects and --tiled-raster\n");
+        renderScale = 1;
+    }
+
+    if (renderScale != 1) {
+        SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+
+        sceneTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, ceil(configuration.winWidth * renderScale), ceil(configuration.winHeight * renderScale));
+        if (sceneTexture == NULL) {
+            SDL_Log("Scene texture cannot be generated %s", SDL_GetError());
+            exit(1);
+        }
+    }
+
+    if (dirtyRectanglesMode) {
+        backgroundSurface = SDL_CreateRGBSurfaceWithFormat(0, windowSurface->w, windowSurface->h, 32, windowSurface->format->format);
+        if (backgroundSurface == NULL) {
+            SDL_Log("Background surface cannot be generated %s", SDL_GetError());
+            exit(1);
+        }
+
+        // Spaceship, its two vectors and the planets
+        nbMovingObjects = 3 + configuration.nbStars;
+
+        previousRects = calloc(nbMovingObjects, sizeof(SDL_Rect));
+        currentRects  = calloc(nbMovingObjects, sizeof(SDL_Rect));
+        dirtyRects    = calloc(2 * nbMovingObjects + 3, sizeof(SDL_Rect));
+    }
+
+    if (tiledRasterMode) {
+        initializeRasterizer(renderer, configuration.winWidth, configuration.winHeight);
+    }
+
+    initializeHud(renderer);
+    initializeParticles();
+
+    // The heatmap changes the whole background, so it needs the frames drawn from scratch by SDL
+    if (!dirtyRectanglesMode && !tiledRasterMode) {
+        initializeHeatmap(renderer, configuration.winWidth, configuration.winHeight);
+    }
+
+    // The trail can cross the whole window, so it needs the frames drawn from scratch too
+    if (dirtyRectanglesMode) trailLength = 0;
+
+    if (trailLength > 0) {
+        initializeTrail(game, trailLength);
+    }
 }
 
 /**
- * Reset the window and display the updated state of the universe
+ * Place the camera on the spaceship, without showing anything outside of the world
+ * 
+ * @param configuration Displayed configuration
+*/
+void updateCamera(Configuration configuration) {
+    camera.posX = configuration.spaceship.position.posX - configuration.winWidth  / 2.0;
+    camera.posY = configuration.spaceship.position.posY - configuration.winHeight / 2.0;
+
+    if (camera.posX > configuration.worldWidth  - configuration.winWidth ) camera.posX = configuration.worldWidth  - configuration.winWidth;
+    if (camera.posY > configuration.worldHeight - configuration.winHeight) camera.posY = configuration.worldHeight - configuration.winHeight;
+    if (camera.posX < 0) camera.posX = 0;
+    if (camera.posY < 0) camera.posY = 0;
+}
+
+/**
+ * Convert world coordinates into window coordinates
+ * 
+ * @param position Coordinates in the world
+ * 
+ * @return Coordinates in the window
 */
-void printActualState() {
-    Configuration configuration = getConfiguration();
+Position toScreen(Position position) {
+    return (Position) {position.posX - camera.posX, position.posY - camera.posY};
+}
 
-    // Resetting the display
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
+/**
+ * Check if a centered object can be seen through the window
+ * 
+ * @param configuration Displayed configuration
+ * @param centerPosition Coordinates of the center of the object in the world
+ * @param halfSize Half of the object's width and height
+ * 
+ * @return True if the object intersects the window, false otherwise
+*/
+bool isInViewport(Configuration configuration, Position centerPosition, int halfSize) {
+    return !(
+        centerPosition.posX + halfSize < camera.posX ||
+        centerPosition.posX - halfSize > camera.posX + configuration.winWidth ||
+        centerPosition.posY + halfSize < camera.posY ||
+        centerPosition.posY - halfSize > camera.posY + configuration.winHeight
+    );
+}
 
-    // Window borders display
+/**
+ * Draw the orbit of a planet (a circle, or an ellipse made of segments)
+ * 
+ * @param sunPosition Position in the world of the sun of the planet
+ * @param planet The planet
+ * @param hexColor Orbit's color in hexadecimal format
+*/
+void drawOrbit(Position sunPosition, Planet planet, Uint32 hexColor) {
+    if (planet.eccentricity == 0) {
+        drawEmptyCircle(toScreen(sunPosition), abs(planet.orbit), hexColor);
+        return;
+    }
+
+    SDL_Point points[ORBIT_SEGMENTS + 1];
+
+    // Points evenly spread along the eccentric anomaly, denser where the ellipse bends the most
+    for (int i = 0; i < ORBIT_SEGMENTS; i++) {
+        double anomaly = i * 2 * M_PI / ORBIT_SEGMENTS;
+        Position point = toScreen(placeOnOrbit(sunPosition, planet, sin(anomaly), cos(anomaly)));
+
+        points[i] = (SDL_Point) {point.posX, point.posY};
+    }
+
+    points[ORBIT_SEGMENTS] = points[0];
+
+    int * rgbaColor = convertHexToRGBA(hexColor);
+
+    if (tiledRasterMode) {
+        for (int i = 0; i < ORBIT_SEGMENTS; i++) {
+            rasterLine(points[i].x, points[i].y, points[i + 1].x, points[i + 1].y, convertRGBAToPixel(rgbaColor));
+        }
+
+        free(rgbaColor);
+        return;
+    }
+
+    SDL_SetRenderDrawColor(renderer, rgbaColor[0], rgbaColor[1], rgbaColor[2], rgbaColor[3]);
+
+    free(rgbaColor);
+
+    SDL_RenderDrawLines(renderer, points, ORBIT_SEGMENTS + 1);
+}
+
+/**
+ * Display the bodies of the chunks seen through the window
+ * 
+ * @param configuration Displayed configuration
+ * @param staticPart True to display the suns and orbits, false to display the planets
+*/
+void drawVisibleBodies(Configuration configuration, bool staticPart) {
+    int firstX = camera.posX / CHUNK_SIZE;
+    int firstY = camera.posY / CHUNK_SIZE;
+    int lastX  = (camera.posX + configuration.winWidth ) / CHUNK_SIZE;
+    int lastY  = (camera.posY + configuration.winHeight) / CHUNK_SIZE;
+
+    if (lastX >= configuration.nbChunksX) lastX = configuration.nbChunksX - 1;
+    if (lastY >= configuration.nbChunksY) lastY = configuration.nbChunksY - 1;
+
+    // Iterate through the visible chunks only
+    for (int y = firstY; y <= lastY; y++) {
+        for (int x = firstX; x <= lastX; x++) {
+            Chunk chunk = configuration.chunks[y * configuration.nbChunksX + x];
+
+            for (int k = 0; k < chunk.nbBodies; k++) {
+                BodyReference body = chunk.bodies[k];
+
+                // A body covering several visible chunks is displayed by the first of them only
+                if (x != (body.firstChunkX > firstX ? body.firstChunkX : firstX) || y != (body.firstChunkY > firstY ? body.firstChunkY : firstY)) continue;
+
+                Sun sun = configuration.solarSystems[body.solarSystem].sun;
+
+                if (body.planet < 0) {
+                    // Sun display
+                    if (staticPart && isInViewport(configuration, sun.position, sun.radius)) {
+                        drawFilledCircle(toScreen(sun.position), sun.radius, SUNS_COLOR);
+                    }
+
+                    continue;
+                }
+
+                Planet planet = configuration.solarSystems[body.solarSystem].planets[body.planet];
+
+                if (staticPart) {
+                    // Planet orbit display
+                    if (showOrbits && isInViewport(configuration, sun.position, ceil(getOrbitReach(planet)))) {
+                        drawOrbit(sun.position, planet, ORBITS_COLOR);
+                    }
+                } else if (isInViewport(configuration, planet.position, planet.radius)) {
+                    // Planet display
+                    drawFilledCircle(toScreen(planet.position), planet.radius, PLANETS_COLOR);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Display the objects that never move (borders, starting and arrival points, suns and orbits)
+ * 
+ * @param configuration Configuration to display
+*/
+void drawStaticObjects(Configuration configuration) {
+    Position borderCorner = toScreen((Position) {OUTER_BORDER_EDGE, OUTER_BORDER_EDGE});
+
+    // World borders display
     drawEmptyRectangle(
-        OUTER_BORDER_EDGE,
-        OUTER_BORDER_EDGE,
-        configuration.winWidth  - 2 * OUTER_BORDER_EDGE,
-        configuration.winHeight - 2 * OUTER_BORDER_EDGE,
+        borderCorner.posX,
+        borderCorner.posY,
+        configuration.worldWidth  - 2 * OUTER_BORDER_EDGE,
+        configuration.worldHeight - 2 * OUTER_BORDER_EDGE,
         OUTER_BORDER_COLOR
     );
 
     // Starting point display
-    drawCenteredEmptySquare(configuration.startingPoint, STARTING_POINT_SIZE, ARRIVAL_POINT_COLOR);
+    drawCenteredEmptySquare(toScreen(configuration.startingPoint), STARTING_POINT_SIZE, ARRIVAL_POINT_COLOR);
 
     // Arrival point display
-    drawCenteredEmptySquare(configuration.arrivalPoint, ARRIVAL_POINT_SIZE, ARRIVAL_POINT_COLOR);
+    drawCenteredEmptySquare(toScreen(configuration.arrivalPoint), ARRIVAL_POINT_SIZE, ARRIVAL_POINT_COLOR);
+
+    // Suns and orbits display
+    drawVisibleBodies(configuration, true);
+}
+
+/**
+ * Display the objects that move (spaceship, its vectors and planets)
+ * 
+ * @param configuration Configuration to display
+*/
+void drawMovingObjects(Configuration configuration) {
+    Position spaceshipPosition = toScreen(configuration.spaceship.position);
 
     // Spaceship display
-    drawCenteredFilledSquare(configuration.spaceship.position, STARTSHIP_SIZE, SPACESHIP_COLOR);
+    drawCenteredFilledSquare(spaceshipPosition, STARTSHIP_SIZE, SPACESHIP_COLOR);
 
     // Vectors influencing the trajectory of the spaceship display (if activated)
     if (showTrajectories) {
-        drawVector(configuration.spaceship.position, configuration.spaceship.trajectoryAngle, TRAJECTORY_COLOR);
-        drawVector(configuration.spaceship.position, configuration.spaceship.gravityAngle,    GRAVITY_COLOR);
+        drawVector(spaceshipPosition, configuration.spaceship.velocity, TRAJECTORY_COLOR);
+        drawVector(spaceshipPosition, configuration.spaceship.gravity,  GRAVITY_COLOR);
+    }
+
+    // Planets display
+    drawVisibleBodies(configuration, false);
+}
+
+/**
+ * Calculate the rectangle covering a centered object, clipped to the window
+ * 
+ * @param configuration Configuration giving the window dimensions
+ * @param centerPosition Coordinates of the center of the object
+ * @param halfSize Half of the object's width and height
+ * 
+ * @return Covering rectangle (empty if outside of the window)
+*/
+SDL_Rect getCenteredBoundingBox(Configuration configuration, Position centerPosition, int halfSize) {
+    // One more pixel on each side to cover the rounding of the drawing functions
+    SDL_Rect box = {(int) centerPosition.posX - halfSize - 1, (int) centerPosition.posY - halfSize - 1, 2 * halfSize + 3, 2 * halfSize + 3};
+    SDL_Rect frame = {0, 0, configuration.winWidth, configuration.winHeight};
+    SDL_Rect clipped = {0, 0, 0, 0};
+
+    if (!SDL_IntersectRect(&box, &frame, &clipped)) {
+        return (SDL_Rect) {0, 0, 0, 0};
+    }
+
+    return clipped;
+}
+
+/**
+ * Calculate the rectangle covering a vector drawn by drawVector(), clipped to the window
+ * 
+ * @param configuration Configuration giving the window dimensions
+ * @param startPosition Coordinates of the starting point of the vector
+ * @param vector Vector's cartesian components
+ * 
+ * @return Covering rectangle (empty if outside of the window)
+*/
+SDL_Rect getVectorBoundingBox(Configuration configuration, Position startPosition, Vector vector) {
+    Position endPosition = {startPosition.posX + 10 * vector.vecX, startPosition.posY + 10 * vector.vecY};
+
+    SDL_Rect start = getCenteredBoundingBox(configuration, startPosition, 0);
+    SDL_Rect end   = getCenteredBoundingBox(configuration, endPosition, 0);
+
+    if (start.w == 0) return end;
+    if (end.w   == 0) return start;
+
+    SDL_Rect box;
+    SDL_UnionRect(&start, &end, &box);
+
+    return box;
+}
+
+/**
+ * Calculate the rectangles covering all the moving objects in their current state
+ * 
+ * @param configuration Configuration to display
+*/
+void updateMovingRects(Configuration configuration) {
+    Spaceship spaceship = configuration.spaceship;
+
+    int index = 0;
+
+    currentRects[index++] = getCenteredBoundingBox(configuration, spaceship.position, STARTSHIP_SIZE / 2);
+
+    if (showTrajectories) {
+        currentRects[index++] = getVectorBoundingBox(configuration, spaceship.position, spaceship.velocity);
+        currentRects[index++] = getVectorBoundingBox(configuration, spaceship.position, spaceship.gravity);
+    } else {
+        currentRects[index++] = (SDL_Rect) {0, 0, 0, 0};
+        currentRects[index++] = (SDL_Rect) {0, 0, 0, 0};
     }
 
     // Iterate through all the solar systems
     for (int i = 0; i < configuration.nbSolarSystems; i++) {
         SolarSystem solarSystem = configuration.solarSystems[i];
 
-        Sun sun = solarSystem.sun;
-
-        // Sun display
-        drawFilledCircle(sun.position, sun.radius, SUNS_COLOR);
-
         // Iterate through all the planets
         for (int j = 0; j < solarSystem.nbPlanets; j++) {
-            Planet planet = solarSystem.planets[j];
+            currentRects[index++] = getCenteredBoundingBox(configuration, solarSystem.planets[j].position, solarSystem.planets[j].radius);
+        }
+    }
 
-            // Planet orbit display
-            drawEmptyCircle(sun.position, abs(planet.orbit), ORBITS_COLOR);
+    // Unused slots (suns are counted in nbStars but never move)
+    while (index < nbMovingObjects) {
+        currentRects[index++] = (SDL_Rect) {0, 0, 0, 0};
+    }
+}
 
-            // Planet display
-            drawFilledCircle(planet.position, planet.radius, PLANETS_COLOR);
+/**
+ * Gather the old and new regions of every moving object
+ * 
+ * @return Number of dirty rectangles
+*/
+int collectDirtyRects() {
+    int nbDirtyRects = 0;
+
+    for (int i = 0; i < nbMovingObjects; i++) {
+        SDL_Rect previous = previousRects[i];
+        SDL_Rect current  = currentRects[i];
+
+        // An object that moved only a little is covered by a single rectangle
+        if (previous.w > 0 && current.w > 0 && SDL_HasIntersection(&previous, &current)) {
+            SDL_UnionRect(&previous, &current, &dirtyRects[nbDirtyRects++]);
+            continue;
         }
+
+        if (previous.w > 0) dirtyRects[nbDirtyRects++] = previous;
+        if (current.w  > 0) dirtyRects[nbDirtyRects++] = current;
+    }
+
+    return nbDirtyRects;
+}
+
+/**
+ * Record the durations of the drawing and of the presentation of a frame for the HUD
+ * 
+ * @param renderStart Performance counter at the start of the drawing
+ * @param presentStart Performance counter at the start of the presentation
+*/
+void recordRenderTimes(Uint64 renderStart, Uint64 presentStart) {
+    double frequency = SDL_GetPerformanceFrequency();
+
+    recordPhaseTime(RENDER_PHASE,  (presentStart - renderStart) * 1000.0 / frequency);
+    recordPhaseTime(PRESENT_PHASE, (SDL_GetPerformanceCounter() - presentStart) * 1000.0 / frequency);
+}
+
+/**
+ * Display the updated state of the universe by repainting only the regions of the moving objects
+ * 
+ * @param configuration Configuration to display
+ * @param renderStart Performance counter at the start of the drawing
+*/
+void printDirtyRectangles(Configuration configuration, Uint64 renderStart) {
+    // The first frame paints everything and keeps the static objects as background
+    if (!backgroundCached) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        drawStaticObjects(configuration);
+        SDL_RenderFlush(renderer);
+
+        SDL_BlitSurface(windowSurface, NULL, backgroundSurface, NULL);
+
+        drawMovingObjects(configuration);
+        drawParticles(renderer, camera, configuration.winWidth, configuration.winHeight, PARTICLES_COLOR);
+        drawHud(renderer, configuration.nbStars);
+        SDL_RenderFlush(renderer);
+
+        updateMovingRects(configuration);
+        previousParticlesRect = getParticlesRectangle(camera, configuration.winWidth, configuration.winHeight);
+        memcpy(previousRects, currentRects, nbMovingObjects * sizeof(SDL_Rect));
+
+        Uint64 presentStart = SDL_GetPerformanceCounter();
+        SDL_UpdateWindowSurface(window);
+        recordRenderTimes(renderStart, presentStart);
+
+        hudWasShown = isHudShown();
+        backgroundCached = true;
+        return;
+    }
+
+    updateMovingRects(configuration);
+
+    int nbDirtyRects = collectDirtyRects();
+
+    // The HUD is repainted over the background like the moving objects
+    if (isHudShown() || hudWasShown) {
+        dirtyRects[nbDirtyRects++] = getHudRectangle();
+    }
+
+    hudWasShown = isHudShown();
+
+    // The particles are covered by a single region, the previous one erasing those that died
+    SDL_Rect particlesRect = getParticlesRectangle(camera, configuration.winWidth, configuration.winHeight);
+
+    if (previousParticlesRect.w > 0) dirtyRects[nbDirtyRects++] = previousParticlesRect;
+    if (particlesRect.w > 0) dirtyRects[nbDirtyRects++] = particlesRect;
+
+    previousParticlesRect = particlesRect;
+
+    // Erasing the moving objects with the cached background
+    for (int i = 0; i < nbDirtyRects; i++) {
+        SDL_Rect destination = dirtyRects[i];
+        SDL_BlitSurface(backgroundSurface, &dirtyRects[i], windowSurface, &destination);
+    }
+
+    drawMovingObjects(configuration);
+    drawParticles(renderer, camera, configuration.winWidth, configuration.winHeight, PARTICLES_COLOR);
+    drawHud(renderer, configuration.nbStars);
+    SDL_RenderFlush(renderer);
+
+    Uint64 presentStart = SDL_GetPerformanceCounter();
+    SDL_UpdateWindowSurfaceRects(window, dirtyRects, nbDirtyRects);
+    recordRenderTimes(renderStart, presentStart);
+
+    // Swapping of the rectangles lists
+    SDL_Rect * rects = previousRects;
+    previousRects = currentRects;
+    currentRects = rects;
+}
+
+/**
+ * Reset the window and display the updated state of the universe
+ * 
+ * @param game Game to display
+*/
+void printActualState(Game * game) {
+    Configuration configuration = getConfiguration(game);
+
+    Uint64 renderStart = SDL_GetPerformanceCounter();
+
+    updateCamera(configuration);
+
+    // Particles of the last tick
+    updateParticles();
+    emitThrustParticles(game);
+
+    if (dirtyRectanglesMode) {
+        printDirtyRectangles(configuration, renderStart);
+        return;
     }
 
+    if (tiledRasterMode) {
+        beginRasterFrame(0xFF000000);
+
+        drawStaticObjects(configuration);
+        drawMovingObjects(configuration);
+
+        endRasterFrame(renderer);
+
+        // Trail, in one batch over the frame
+        drawTrail(renderer, game, camera, configuration.winWidth, configuration.winHeight, TRAIL_COLOR);
+    } else {
+        // Smaller frame, the drawing keeping the coordinates of the window
+        if (sceneTexture != NULL) {
+            SDL_SetRenderTarget(renderer, sceneTexture);
+            SDL_RenderSetScale(renderer, renderScale, renderScale);
+        }
+
+        // Resetting the display
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        // Gravity heatmap display (if activated)
+        if (showHeatmap) {
+            drawHeatmap(renderer, game, camera);
+        }
+
+        drawStaticObjects(configuration);
+
+        // Trail, in one batch under the spaceship
+        drawTrail(renderer, game, camera, configuration.winWidth, configuration.winHeight, TRAIL_COLOR);
+
+        drawMovingObjects(configuration);
+    }
+
+    // Particles, in one batch over the frame
+    drawParticles(renderer, camera, configuration.winWidth, configuration.winHeight, PARTICLES_COLOR);
+
+    // Upscaling of the frame to the window
+    if (sceneTexture != NULL) {
+        SDL_SetRenderTarget(renderer, NULL);
+
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        SDL_RenderCopy(renderer, sceneTexture, NULL, NULL);
+    }
+
+    // Performance overlay (if activated)
+    drawHud(renderer, configuration.nbStars);
+
+    Uint64 presentStart = SDL_GetPerformanceCounter();
     SDL_RenderPresent(renderer);
+    recordRenderTimes(renderStart, presentStart);
+}
+
+/**
+ * Take into account a change of the static objects of the game (after a configuration reload)
+ * 
+ * @param game Displayed game
+*/
+void resetStaticObjects(Game * game) {
+    if (!dirtyRectanglesMode) return;
+
+    // The number of moving objects may have changed
+    free(previousRects);
+    free(currentRects);
+    free(dirtyRects);
+
+    nbMovingObjects = 3 + getConfiguration(game).nbStars;
+
+    previousRects = calloc(nbMovingObjects, sizeof(SDL_Rect));
+    currentRects  = calloc(nbMovingObjects, sizeof(SDL_Rect));
+    dirtyRects    = calloc(2 * nbMovingObjects + 3, sizeof(SDL_Rect));
+
+    // The background is painted again on the next frame
+    backgroundCached = false;
 }
 
 /**
  * Closing SDL objects and freeing dynamically allocated memories
 */
 void freeSDL() {
+    if (dirtyRectanglesMode) {
+        SDL_FreeSurface(backgroundSurface);
+
+        free(previousRects);
+        free(currentRects);
+        free(dirtyRects);
+    }
+
+    if (tiledRasterMode) {
+        freeRasterizer();
+    }
+
+    freeHud();
+    freeParticles();
+
+    if (!dirtyRectanglesMode && !tiledRasterMode) {
+        freeHeatmap();
+    }
+
+    if (sceneTexture != NULL) {
+        SDL_DestroyTexture(sceneTexture);
+    }
+
+    if (trailLength > 0) {
+        freeTrail();
+    }
+
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
 }
 
+/**
+ * Enables or disables the dirty rectangles mode (must be called before initializeRenderer())
+ * 
+ * @param enabled True to repaint only the regions of the moving objects
+*/
+void setDirtyRectanglesMode(bool enabled) {
+    dirtyRectanglesMode = enabled;
+}
+
+/**
+ * Enables or disables the tiled raster mode (must be called before initializeRenderer())
+ * 
+ * @param enabled True to draw the frames with the internal multithreaded rasterizer
+*/
+void setTiledRasterMode(bool enabled) {
+    tiledRasterMode = enabled;
+}
+
+/**
+ * Change the resolution of the drawn frames (must be called before initializeRenderer())
+ * 
+ * @param scale Ratio to the window's resolution, between 0 and 1
+*/
+void setRenderScale(float scale) {
+    renderScale = scale;
+}
+
+/**
+ * Change the number of positions of the spaceship's trail (must be called before initializeRenderer())
+ * 
+ * @param length Number of positions, 0 to draw no trail
+*/
+void setTrailLength(int length) {
+    trailLength = length;
+}
+
+/**
+ * Shows or hides the orbits (the planets leave them in the N-body mode)
+ * 
+ * @param shown True to display the orbits
+*/
+void setOrbitsShowing(bool shown) {
+    showOrbits = shown;
+}
+
+/**
+ * Changes the state of the variable managing the display of the gravity heatmap
+*/
+void permuteHeatmapShowing() {
+    if (dirtyRectanglesMode || tiledRasterMode) {
+        printf("The gravity heatmap is not available with --dirty-rects and --tiled-raster\n");
+        return;
+    }
+
+    showHeatmap = !showHeatmap;
+}
+
 /**
  * Changes the state of the variable managing the display of vectors
 */
@@ -242,11 +934,12 @@ void permuteTrajectoriesShowing() {
 /**
  * Updates the title of the window
  * 
+ * @param game Displayed game
  * @param currentTime Actual timestamp
  * @param lastTime Timestamp of the last update
 */
-void updateTitle(float currentTime, float lastTime) {
+void updateTitle(Game * game, float currentTime, float lastTime) {
     char title[50];
-    sprintf(title, "ProjetC_oleil | FPS: %.1f | Score: %d", 1000 / (currentTime - lastTime), getConfiguration().score);
+    sprintf(title, "ProjetC_oleil | FPS: %.1f | Score: %d", 1000 / (currentTime - lastTime), getConfiguration(game).score);
     SDL_SetWindowTitle(window, title);
 }
\ No newline at end of file
@@ -1,10 +1,18 @@
 #ifndef VUE_CONTROLLER_H
 #define VUE_CONTROLLER_H
 
+void setDirtyRectanglesMode(bool enabled);
+void setTiledRasterMode(bool enabled);
+void setRenderScale(float scale);
+void setTrailLength(int length);
+void setOrbitsShowing(bool shown);
 void permuteTrajectoriesShowing();
-void initializeRenderer();
-void printActualState();
+void permuteHeatmapShowing();
+void initializeWindow();
+void initializeRenderer(Game * game);
+void printActualState(Game * game);
+void resetStaticObjects(Game * game);
 void freeSDL();
-void updateTitle(float currentTime, float lastTime);
+void updateTitle(Game * game, float currentTime, float lastTime);
 
 #endif
\ No newline at end of file
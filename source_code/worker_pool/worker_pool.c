@@ -0,0 +1,145 @@
+#include <stdbool.h>
+
+#include <SDL2/SDL2_gfxPrimitives.h>
+
+#include "worker_pool.h"
+
+// Worker of a pool, knowing its number
+typedef struct {
+    WorkerPool * pool;
+    int thread;
+} Worker;
+
+struct WorkerPool {
+    int nbWorkers;
+    Worker * workers;
+    SDL_Thread ** threads;
+
+    // Each worker is woken up by its own semaphore, so that it runs the task exactly once per call
+    SDL_sem ** workStarts;
+    SDL_sem * workDone;
+
+    // Task of the running call
+    WorkerTask task;
+    void * data;
+
+    bool stopping;
+};
+
+/**
+ * Main function of a worker: runs the task each time it is woken up
+ * 
+ * @param data The worker
+ * 
+ * @return Always 0
+*/
+int poolWorker(void * data) {
+    Worker * worker = data;
+    WorkerPool * pool = worker->pool;
+
+    while (true) {
+        SDL_SemWait(pool->workStarts[worker->thread - 1]);
+
+        if (pool->stopping) break;
+
+        pool->task(worker->thread, pool->data);
+
+        SDL_SemPost(pool->workDone);
+    }
+
+    return 0;
+}
+
+/**
+ * Start a worker on each core but one, the calling thread working too
+ * 
+ * @param name Name of the threads
+ * 
+ * @return The pool
+*/
+WorkerPool * createWorkerPool(char * name) {
+    WorkerPool * pool = calloc(1, sizeof(WorkerPool));
+
+    // The calling thread works too, so one worker less than the number of cores
+    pool->nbWorkers = SDL_GetCPUCount() - 1;
+    if (pool->nbWorkers < 0) pool->nbWorkers = 0;
+
+    pool->workers    = malloc((pool->nbWorkers + 1) * sizeof(Worker));
+    pool->threads    = malloc((pool->nbWorkers + 1) * sizeof(SDL_Thread *));
+    pool->workStarts = malloc((pool->nbWorkers + 1) * sizeof(SDL_sem *));
+    pool->workDone   = SDL_CreateSemaphore(0);
+
+    for (int i = 0; i < pool->nbWorkers; i++) {
+        pool->workers[i] = (Worker) {pool, i + 1};
+        pool->workStarts[i] = SDL_CreateSemaphore(0);
+        pool->threads[i] = SDL_CreateThread(poolWorker, name, &pool->workers[i]);
+    }
+
+    return pool;
+}
+
+/**
+ * Get the number of threads of a pool
+ * 
+ * @param pool The pool
+ * 
+ * @return Number of workers, plus the calling thread
+*/
+int getWorkerPoolSize(WorkerPool * pool) {
+    return pool->nbWorkers + 1;
+}
+
+/**
+ * Run a task on several threads of a pool and wait for all of them (a pool runs one call at a time)
+ * 
+ * @param pool The pool
+ * @param nbThreads Number of threads wanted, the calling thread included (fewer if the pool is smaller)
+ * @param task The task, called once by each thread with its number, from 0 to the number of threads used minus 1
+ * @param data Argument of the task
+ * 
+ * @return Number of threads used
+*/
+int runWorkerPool(WorkerPool * pool, int nbThreads, WorkerTask task, void * data) {
+    if (nbThreads > pool->nbWorkers + 1) nbThreads = pool->nbWorkers + 1;
+    if (nbThreads < 1) nbThreads = 1;
+
+    pool->task = task;
+    pool->data = data;
+
+    for (int i = 1; i < nbThreads; i++) {
+        SDL_SemPost(pool->workStarts[i - 1]);
+    }
+
+    task(0, data);
+
+    for (int i = 1; i < nbThreads; i++) {
+        SDL_SemWait(pool->workDone);
+    }
+
+    return nbThreads;
+}
+
+/**
+ * Stop the workers of a pool and free it
+ * 
+ * @param pool The pool
+*/
+void freeWorkerPool(WorkerPool * pool) {
+    pool->stopping = true;
+
+    for (int i = 0; i < pool->nbWorkers; i++) {
+        SDL_SemPost(pool->workStarts[i]);
+    }
+
+    for (int i = 0; i < pool->nbWorkers; i++) {
+        SDL_WaitThread(pool->threads[i], NULL);
+        SDL_DestroySemaphore(pool->workStarts[i]);
+    }
+
+    SDL_DestroySemaphore(pool->workDone);
+
+    free(pool->workers);
+    free(pool->threads);
+    free(pool->workStarts);
+    free(pool);
+}
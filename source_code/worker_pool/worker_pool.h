@@ -0,0 +1,14 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+// Work run by each thread of a pool (the calling thread being the number 0)
+typedef void (* WorkerTask)(int thread, void * data);
+
+typedef struct WorkerPool WorkerPool;
+
+WorkerPool * createWorkerPool(char * name);
+int getWorkerPoolSize(WorkerPool * pool);
+int runWorkerPool(WorkerPool * pool, int nbThreads, WorkerTask task, void * data);
+void freeWorkerPool(WorkerPool * pool);
+
+#endif
\ No newline at end of file